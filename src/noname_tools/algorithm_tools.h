@@ -24,8 +24,25 @@
 
 #include <iterator>
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <array>
+#include <limits>
+#include <cstring>
+#include <atomic>
+#include <initializer_list>
 
 #include "functional_tools.h"
+#include "memory_tools.h"
+#include "parallel_tools.h"
+#include "range_tools.h"
+#include "typetraits_tools.h"
 
 namespace noname {
     namespace tools {
@@ -59,6 +76,137 @@ namespace noname {
             *dest++ = last;
         }
 
+        namespace _detail {
+            //! Writes the subrange boundaries of a range with dist elements given the inclusive prefix sums of the element weights
+            template<typename ForwardIt, typename OutputIt, typename RandomIt>
+            void _n_subranges_weighted(ForwardIt first, ForwardIt last, OutputIt dest, std::size_t n,
+                                       std::size_t dist, RandomIt cumulative_weights) {
+                if (n == 0) return;
+                if (dist == 0) return;
+
+                n = std::min<std::size_t>(n, dist);
+                // Ranges without any weight are divided by element count
+                const double total = static_cast<double>(cumulative_weights[dist - 1]);
+                const bool weighted = total > 0;
+
+                *dest++ = first;
+
+                std::size_t prev_bound = 0;
+                for (std::size_t k = 1; k < n; k++) {
+                    const double target = total * static_cast<double>(k) / static_cast<double>(n);
+                    // Index of the first element whose cumulative weight exceeds the target
+                    std::size_t bound = weighted
+                                        ? std::upper_bound(cumulative_weights, cumulative_weights + dist, target,
+                                                           [](double t, const auto &c) { return t < static_cast<double>(c); })
+                                          - cumulative_weights
+                                        : dist * k / n;
+                    // Include the element if that brings the cumulative weight closer to the target
+                    if (weighted && bound < dist) {
+                        const double before = (bound > 0) ? static_cast<double>(cumulative_weights[bound - 1]) : 0.0;
+                        if (static_cast<double>(cumulative_weights[bound]) - target < target - before) bound += 1;
+                    }
+                    // Every subrange has to contain at least one element
+                    bound = std::max(bound, prev_bound + 1);
+                    bound = std::min(bound, dist - (n - k));
+
+                    first = std::next(first, bound - prev_bound);
+                    *dest++ = first;
+                    prev_bound = bound;
+                }
+
+                *dest++ = last;
+            }
+        }
+
+        //! Divides a range in n subranges of (nearly) equal total weight and writes the n+1 boundaries into dest like n_subranges, the weights are given by the inclusive prefix sums starting at cumulative_weights
+        template<typename ForwardIt, typename OutputIt, typename RandomIt>
+        void n_subranges_weighted_cumulative(ForwardIt first, ForwardIt last, OutputIt dest, std::size_t n, RandomIt cumulative_weights) {
+            const auto dist = static_cast<std::size_t>(std::distance(first, last));
+            _detail::_n_subranges_weighted(first, last, dest, n, dist, cumulative_weights);
+        }
+
+        //! Divides a range in n subranges of (nearly) equal total weight and writes the n+1 boundaries into dest like n_subranges, the non-negative weight of every element is given by weight(element)
+        template<typename ForwardIt, typename OutputIt, typename WeightFunc>
+        void n_subranges_weighted(ForwardIt first, ForwardIt last, OutputIt dest, std::size_t n, WeightFunc weight) {
+            using weight_t = typename std::decay<decltype(weight(*first))>::type;
+
+            std::vector<weight_t> cumulative_weights;
+            weight_t sum = weight_t();
+            for (auto it = first; it != last; ++it) {
+                sum += weight(*it);
+                cumulative_weights.push_back(sum);
+            }
+
+            _detail::_n_subranges_weighted(first, last, dest, n, cumulative_weights.size(), cumulative_weights.begin());
+        }
+
+        namespace _detail {
+            //! Checks whether the iterator is known to point into contiguous storage, i.e. whether it is a pointer or an iterator of std::vector
+            template<typename It, typename T = typename std::iterator_traits<It>::value_type>
+            struct _is_contiguous_iterator : bool_constant<std::is_pointer<It>::value
+                                                           || std::is_same<It, typename std::vector<T>::iterator>::value
+                                                           || std::is_same<It, typename std::vector<T>::const_iterator>::value> {
+            };
+
+            template<typename It>
+            struct _is_contiguous_iterator<It, bool> : std::is_pointer<It> {
+            };
+        }
+
+        //! Divides a contiguous range in up to n (nearly) equal sized subranges whose inner boundaries are aligned to the specified number of bytes and writes the boundaries into dest like n_subranges
+        /*
+         * The alignment has to be a power of two, e.g. cache_line_size, page_size or the width of a SIMD register.
+         * If the range contains less than n-1 aligned elements, it is divided into fewer subranges.
+         */
+        template<typename RandomIt, typename OutputIt>
+        void n_subranges_aligned(RandomIt first, RandomIt last, OutputIt dest, std::size_t n, std::size_t alignment = cache_line_size) {
+            static_assert(_detail::_is_contiguous_iterator<RandomIt>::value,
+                          "The range has to be contiguous, i.e. the iterators have to be pointers or std::vector iterators.");
+            if (n == 0) return;
+            if (first == last) return;
+
+            const auto dist = static_cast<std::size_t>(std::distance(first, last));
+            const std::size_t element_size = sizeof(typename std::iterator_traits<RandomIt>::value_type);
+            const auto address = reinterpret_cast<std::uintptr_t>(std::addressof(*first));
+
+            // Aligned elements are step elements apart, starting with the element at offset
+            std::size_t gcd = alignment, remainder = element_size;
+            while (remainder != 0) {
+                const std::size_t next = gcd % remainder;
+                gcd = remainder;
+                remainder = next;
+            }
+            const std::size_t step = alignment / gcd;
+            std::size_t offset = 0;
+            while (offset < step && (address + offset * element_size) % alignment != 0) offset++;
+            // Fall back to alignment relative to the first element if no element is aligned
+            if (offset == step) offset = 0;
+
+            // Indices j of the aligned elements that can be inner boundaries, i.e. that satisfy 0 < offset + j * step < dist
+            const std::size_t j_min = (offset == 0) ? 1 : 0;
+            const std::size_t j_end = (dist > offset) ? (dist - 1 - offset) / step + 1 : 0;
+            const std::size_t n_candidates = (j_end > j_min) ? j_end - j_min : 0;
+            n = std::min<std::size_t>(n, n_candidates + 1);
+
+            *dest++ = first;
+
+            std::size_t prev_j = j_min;
+            for (std::size_t k = 1; k < n; k++) {
+                // Round the boundary of the unaligned split to the nearest aligned element
+                const double ideal = static_cast<double>(dist) * static_cast<double>(k) / static_cast<double>(n);
+                const double rounded = std::round((ideal - static_cast<double>(offset)) / static_cast<double>(step));
+                std::size_t j = (rounded > 0) ? static_cast<std::size_t>(rounded) : 0;
+                // Every subrange has to contain at least one element
+                j = std::max(j, (k == 1) ? j_min : prev_j + 1);
+                j = std::min(j, j_end - (n - k));
+
+                *dest++ = std::next(first, offset + j * step);
+                prev_j = j;
+            }
+
+            *dest++ = last;
+        }
+
         //! Applies the given function object to every element and its successor, returns copy/move of functor
         template<typename InputIt, typename Func>
         Func for_each_and_successor(InputIt first, InputIt last, Func f) {
@@ -73,6 +221,212 @@ namespace noname {
             return std::move(f);
         }
 
+        namespace _detail {
+            //! Applies a copy of f per chunk to every element and its successor in parallel, returns the functors of all chunks in order
+            template<typename ForwardIt, typename Func>
+            std::vector<Func> _parallel_for_each_and_successor(const parallel_policy &policy, ForwardIt first, ForwardIt last, const Func &f) {
+                std::vector<Func> functors;
+                if (first == last) return functors;
+
+                // The chunks are formed from the first elements of the pairs, so a pair spanning a chunk boundary is processed only by the chunk on its left
+                const auto last_pair = std::next(first, std::distance(first, last) - 1);
+                std::vector<ForwardIt> bounds;
+                n_subranges(first, last_pair, std::back_inserter(bounds), policy.chunk_count());
+                if (bounds.empty()) return functors;
+
+                const std::size_t n_chunks = bounds.size() - 1;
+                functors.reserve(n_chunks);
+                for (std::size_t i = 0; i < n_chunks; ++i) functors.push_back(f);
+
+                policy.parallel_for(n_chunks, [&](std::size_t i) {
+                    for_each_and_successor(bounds[i], std::next(bounds[i + 1]), std::ref(functors[i]));
+                });
+
+                return functors;
+            }
+        }
+
+        //! Applies copies of the function object to every element and its successor in parallel, every chunk of the range uses its own copy
+        template<typename ForwardIt, typename Func>
+        void for_each_and_successor(const parallel_policy &policy, ForwardIt first, ForwardIt last, Func f) {
+            _detail::_parallel_for_each_and_successor(policy, first, last, f);
+        }
+
+        //! Applies copies of the function object to every element and its successor in parallel, returns the functors of all chunks combined in order by reduce(lhs, rhs)
+        template<typename ForwardIt, typename Func, typename Reduce>
+        Func for_each_and_successor(const parallel_policy &policy, ForwardIt first, ForwardIt last, Func f, Reduce reduce) {
+            auto functors = _detail::_parallel_for_each_and_successor(policy, first, last, f);
+            if (functors.empty()) return f;
+
+            callable_container<Func> result{std::move(functors.front())};
+            for (std::size_t i = 1; i < functors.size(); ++i) {
+                result = callable_container<Func>{reduce(std::move(result.callable), std::move(functors[i]))};
+            }
+            return std::move(result.callable);
+        }
+
+        //! Applies the given function object to every N consecutive elements of the range, i.e. f(*it, *(it + 1), ..., *(it + N - 1)) for every window, returns copy/move of functor
+        template<std::size_t N, typename ForwardIt, typename Func>
+        Func for_each_window(ForwardIt first, ForwardIt last, Func f) {
+            static_assert(N > 0, "The window has to contain at least one element.");
+
+            std::array<ForwardIt, N> window;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (first == last) return f;
+                window[i] = first++;
+            }
+
+            while (true) {
+                apply_index_sequence<N>([&](auto... is) { f(*window[is]...); });
+                if (first == last) break;
+                for (std::size_t i = 1; i < N; ++i) window[i - 1] = window[i];
+                window[N - 1] = first++;
+            }
+
+            return f;
+        }
+
+        //! Applies the given function object to an iterator_range over every w consecutive elements of the range, returns copy/move of functor
+        template<typename ForwardIt, typename Func>
+        Func for_each_window(ForwardIt first, ForwardIt last, std::size_t w, Func f) {
+            if (w == 0) return f;
+
+            auto window_end = first;
+            for (std::size_t i = 0; i < w; ++i) {
+                if (window_end == last) return f;
+                ++window_end;
+            }
+
+            while (true) {
+                f(iterator_range<ForwardIt>(first, window_end));
+                if (window_end == last) break;
+                ++first;
+                ++window_end;
+            }
+
+            return f;
+        }
+
+        //! Maximum in the order of comp (e.g. the minimum for std::greater) of the last width values pushed to it, updated in amortized O(1) per value
+        /*
+         * The window keeps a monotonic deque of the values that may still become the maximum, i.e. every value that is followed
+         * by a larger value is dropped. The deque is stored in a ring buffer with room for width + 1 entries.
+         */
+        template<typename T, typename Compare = std::less<>>
+        class sliding_window_max {
+        public:
+            //! Constructs an empty window over the last width values, width has to be positive
+            explicit sliding_window_max(std::size_t width, Compare comp = Compare())
+                    : m_width(width), m_comp(std::move(comp)), m_ring(width + 1) {}
+
+            //! Adds a value to the window, the oldest value leaves the window if it contained width values before
+            void push(T value) {
+                while (m_size != 0 && !m_comp(value, entry(m_size - 1).second)) --m_size;
+                entry(m_size++) = std::make_pair(m_pushed++, std::move(value));
+                if (entry(0).first + m_width < m_pushed) {
+                    m_head = (m_head + 1) % m_ring.size();
+                    --m_size;
+                }
+            }
+
+            //! Returns the maximum of the values in the window, the window may not be empty
+            const T &value() const {
+                return entry(0).second;
+            }
+
+            //! Returns the number of values in the window
+            std::size_t size() const {
+                return static_cast<std::size_t>(std::min<std::uint64_t>(m_pushed, m_width));
+            }
+
+            //! Returns the maximum number of values in the window
+            std::size_t width() const {
+                return m_width;
+            }
+
+            //! Removes all values from the window
+            void clear() {
+                m_head = 0;
+                m_size = 0;
+                m_pushed = 0;
+            }
+
+        private:
+            std::pair<std::uint64_t, T> &entry(std::size_t i) {
+                return m_ring[(m_head + i) % m_ring.size()];
+            }
+
+            const std::pair<std::uint64_t, T> &entry(std::size_t i) const {
+                return m_ring[(m_head + i) % m_ring.size()];
+            }
+
+            std::size_t m_width;
+            Compare m_comp;
+            //! Candidates for the maximum with the number of values pushed before them, in the order they were pushed
+            std::vector<std::pair<std::uint64_t, T>> m_ring;
+            std::size_t m_head = 0;
+            std::size_t m_size = 0;
+            std::uint64_t m_pushed = 0;
+        };
+
+        //! Sum of the last width values pushed to it, updated in O(1) per value by subtracting the value that leaves the window
+        /*
+         * For floating point values the sum is recomputed from the window every width values, so rounding errors do not accumulate over long series.
+         */
+        template<typename T>
+        class sliding_window_sum {
+        public:
+            //! Constructs an empty window over the last width values, width has to be positive
+            explicit sliding_window_sum(std::size_t width, T zero = T())
+                    : m_zero(zero), m_sum(zero), m_values(width, zero) {}
+
+            //! Adds a value to the window, the oldest value leaves the window if it contained width values before
+            void push(const T &value) {
+                if (m_size == m_values.size()) {
+                    m_sum -= m_values[m_next];
+                } else {
+                    ++m_size;
+                }
+                m_values[m_next] = value;
+                m_sum += value;
+                if (++m_next == m_values.size()) {
+                    m_next = 0;
+                    if (std::is_floating_point<T>::value) m_sum = std::accumulate(m_values.begin(), m_values.end(), m_zero);
+                }
+            }
+
+            //! Returns the sum of the values in the window
+            const T &value() const {
+                return m_sum;
+            }
+
+            //! Returns the number of values in the window
+            std::size_t size() const {
+                return m_size;
+            }
+
+            //! Returns the maximum number of values in the window
+            std::size_t width() const {
+                return m_values.size();
+            }
+
+            //! Removes all values from the window
+            void clear() {
+                std::fill(m_values.begin(), m_values.end(), m_zero);
+                m_sum = m_zero;
+                m_size = 0;
+                m_next = 0;
+            }
+
+        private:
+            T m_zero;
+            T m_sum;
+            //! Ring buffer of the values in the window, values not pushed yet are zero
+            std::vector<T> m_values;
+            std::size_t m_size = 0;
+            std::size_t m_next = 0;
+        };
+
         //! Returns the first element in the specified range that is unequal to its predecessor, uses not-equal (!=) operator for comparison
         template<typename InputIt>
         InputIt find_unequal_successor(InputIt first, InputIt last) {
@@ -101,6 +455,54 @@ namespace noname {
             return last;
         }
 
+        //! Returns the first element in the specified range that is unequal to its predecessor, uses p to compare two elements for inequality, the chunks are searched in parallel and stop once a chunk before them found an element
+        /*
+         * Every chunk checks the index of the first chunk with a result so far before every block of 1024 pairs. Chunks to
+         * the left of that chunk continue their search because they may still contain an earlier result, so the siblings
+         * are stopped through this shared index instead of the cancellation token, which would stop all of them. The
+         * cancellation token of the policy is checked at the same points, so a running search can also be cancelled.
+         */
+        template<typename ForwardIt, typename BinaryPredicate>
+        ForwardIt find_unequal_successor(const parallel_policy &policy, ForwardIt first, ForwardIt last, BinaryPredicate p) {
+            if (first == last) return last;
+
+            // The chunks are formed from the first elements of the pairs like in the parallel for_each_and_successor
+            const auto last_pair = std::next(first, std::distance(first, last) - 1);
+            std::vector<ForwardIt> bounds;
+            n_subranges(first, last_pair, std::back_inserter(bounds), policy.chunk_count());
+            if (bounds.empty()) return last;
+            const std::size_t n_chunks = bounds.size() - 1;
+
+            constexpr std::size_t check_interval = 1024;
+            std::atomic<std::size_t> first_found(n_chunks);
+            std::vector<ForwardIt> found(n_chunks, last);
+            policy.parallel_for(n_chunks, [&](std::size_t c) {
+                std::size_t count = 0;
+                for (auto it = bounds[c]; it != bounds[c + 1]; ++it) {
+                    if (count++ % check_interval == 0) {
+                        if (policy.cancellation != nullptr) policy.cancellation->throw_if_cancelled();
+                        if (first_found.load(std::memory_order_relaxed) < c) return;
+                    }
+                    const auto next = std::next(it);
+                    if (p(*it, *next)) {
+                        found[c] = next;
+                        std::size_t expected = first_found.load();
+                        while (c < expected && !first_found.compare_exchange_weak(expected, c)) {}
+                        return;
+                    }
+                }
+            });
+
+            const std::size_t c = first_found.load();
+            return (c < n_chunks) ? found[c] : last;
+        }
+
+        //! Returns the first element in the specified range that is unequal to its predecessor, uses not-equal (!=) operator for comparison, the chunks are searched in parallel and stop once a chunk before them found an element
+        template<typename ForwardIt>
+        ForwardIt find_unequal_successor(const parallel_policy &policy, ForwardIt first, ForwardIt last) {
+            return find_unequal_successor(policy, first, last, [](const auto &a, const auto &b) { return a != b; });
+        }
+
         //! Copies the elements from the specified range to dest in such a way that all groups of consecutive equal objects are omitted
         template<typename InputIt, typename OutputIt>
         OutputIt strict_unique_copy(InputIt first, InputIt last, OutputIt dest) {
@@ -165,55 +567,2039 @@ namespace noname {
             return dest;
         }
 
+        //! Copies the elements from the specified range to dest in such a way that all groups of consecutive equal objects are omitted, the chunks of the range are processed in parallel and collected in a sharded_sink, uses p to compare elements for equality
+        template<typename BidirIt, typename OutputIt, typename BinaryPredicate>
+        OutputIt strict_unique_copy(const parallel_policy &policy, BidirIt first, BidirIt last, OutputIt dest, BinaryPredicate p) {
+            if (first == last) return dest;
+
+            std::vector<BidirIt> bounds;
+            n_subranges(first, last, std::back_inserter(bounds), policy.chunk_count());
+            sharded_sink<typename std::iterator_traits<BidirIt>::value_type> sink(bounds.size() - 1);
+
+            policy.parallel_for(sink.shard_count(), [&](std::size_t k) {
+                auto current = bounds[k];
+                const auto chunk_last = bounds[k + 1];
+                if (current == chunk_last) return;
+
+                auto out = sink.shard(k);
+                // The groups may extend across the chunk boundaries, so the neighbors outside of the chunk are compared too
+                bool prev_check = (current != first) && p(*std::prev(current), *current);
+                while (current != chunk_last) {
+                    const auto next = std::next(current);
+                    const bool cur_check = (next != last) && p(*current, *next);
+                    if (!prev_check && !cur_check) *out++ = *current;
+                    prev_check = cur_check;
+                    current = next;
+                }
+            });
+
+            return sink.merge(dest);
+        }
+
+        //! Copies the elements from the specified range to dest in such a way that all groups of consecutive equal objects are omitted, the chunks of the range are processed in parallel and collected in a sharded_sink
+        template<typename BidirIt, typename OutputIt>
+        OutputIt strict_unique_copy(const parallel_policy &policy, BidirIt first, BidirIt last, OutputIt dest) {
+            return strict_unique_copy(policy, first, last, dest, std::equal_to<>());
+        }
+
         namespace _detail {
-            //! Output iterator adapter which forwards to a callable
-            template<typename Func>
-            struct _output_iterator_adapter {
-                using value_type = void;
-                using difference_type = void;
-                using pointer = void;
-                using reference = void;
-                using iterator_category = std::output_iterator_tag;
+            //! Spreads the bits of a hash value over all bits (finalizer of splitmix64), identity hashes of small integers would otherwise all fall into the same partition
+            inline std::uint64_t _mix_hash(std::uint64_t x) {
+                x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+                x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+                return x ^ (x >> 31);
+            }
 
-                //! The callable used for the output iterator
-                callable_container<Func> f;
+            //! Returns a flag for every element of the range whether no other element is equal to it
+            /*
+             * The hashes are computed per chunk and used to scatter the element indices into partitions by their top bits.
+             * Every partition then counts its elements in its own open addressing table, so no table is shared between threads.
+             * The tables use a scalar linear probe that compares one slot at a time and stops at the first empty or matching slot,
+             * there is no group probe comparing a block of control bytes at once.
+             */
+            template<typename RandomIt, typename Hash, typename KeyEqual, typename ForEach>
+            std::vector<char> _unique_flags(RandomIt first, RandomIt last, Hash &hash, KeyEqual &eq, std::size_t n_chunks, ForEach for_each) {
+                const auto n = static_cast<std::size_t>(last - first);
+                n_chunks = std::max<std::size_t>(std::min(n_chunks, n), 1);
+                // At least one partition per chunk and small enough partitions for their tables to stay in the cache
+                constexpr std::size_t partition_target_size = 1 << 15;
+                constexpr unsigned max_partition_bits = 10;
+                unsigned partition_bits = 0;
+                while (partition_bits < max_partition_bits
+                       && ((std::size_t(1) << partition_bits) < n_chunks || (n >> partition_bits) > partition_target_size)) {
+                    ++partition_bits;
+                }
+                const std::size_t n_partitions = std::size_t(1) << partition_bits;
+                const auto partition = [partition_bits](std::uint64_t h) {
+                    return (partition_bits == 0) ? std::size_t(0) : static_cast<std::size_t>(h >> (64 - partition_bits));
+                };
+                const auto chunk_first = [n, n_chunks](std::size_t k) { return n * k / n_chunks; };
 
-                //! Assignment operator to emulate output iterators, forwards its argument to the stored callable
-                template<typename T,
-                        /* Use SFINAE to avoid confusion with copy-assignment operator */
-                        typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, _output_iterator_adapter>::value>::type>
-                _output_iterator_adapter &operator=(const T &value) {
-                    f.callable(value);
-                    return *this;
+                // Hash all elements and count the elements of every partition per chunk
+                std::vector<std::uint64_t> hashes(n);
+                std::vector<std::size_t> offsets(n_chunks * n_partitions, 0);
+                for_each(n_chunks, [&](std::size_t k) {
+                    for (std::size_t i = chunk_first(k); i < chunk_first(k + 1); ++i) {
+                        hashes[i] = _mix_hash(static_cast<std::uint64_t>(hash(first[i])));
+                        offsets[k * n_partitions + partition(hashes[i])]++;
+                    }
+                });
+
+                // Partition-major offsets keep the indices of every partition in ascending order
+                std::vector<std::size_t> partition_bounds(n_partitions + 1, 0);
+                std::size_t running = 0;
+                for (std::size_t p = 0; p < n_partitions; ++p) {
+                    partition_bounds[p] = running;
+                    for (std::size_t k = 0; k < n_chunks; ++k) {
+                        const std::size_t count = offsets[k * n_partitions + p];
+                        offsets[k * n_partitions + p] = running;
+                        running += count;
+                    }
                 }
+                partition_bounds[n_partitions] = running;
 
-                //! Assignment operator to emulate output iterators, forwards its argument to the stored callable
-                template<typename T,
-                        /* Use SFINAE to avoid confusion with copy-assignment operator */
-                        typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, _output_iterator_adapter>::value>::type>
-                _output_iterator_adapter &operator=(T &&value) {
-                    f.callable(std::forward<T>(value));
-                    return *this;
+                std::vector<std::size_t> order(n);
+                for_each(n_chunks, [&](std::size_t k) {
+                    for (std::size_t i = chunk_first(k); i < chunk_first(k + 1); ++i) order[offsets[k * n_partitions + partition(hashes[i])]++] = i;
+                });
+
+                std::vector<char> flags(n, 0);
+                for_each(n_partitions, [&](std::size_t p) {
+                    const std::size_t m = partition_bounds[p + 1] - partition_bounds[p];
+                    if (m == 0) return;
+                    std::size_t capacity = 1;
+                    while (capacity < 2 * m) capacity *= 2;
+                    const std::size_t mask = capacity - 1;
+
+                    // Slots store the index of the first occurrence plus one, the top bit marks keys that occurred more than once
+                    constexpr std::uint64_t duplicate_bit = std::uint64_t(1) << 63;
+                    std::vector<std::uint64_t> table(capacity, 0);
+                    for (std::size_t j = partition_bounds[p]; j < partition_bounds[p + 1]; ++j) {
+                        const std::size_t i = order[j];
+                        std::size_t slot = static_cast<std::size_t>(hashes[i]) & mask;
+                        while (true) {
+                            auto &entry = table[slot];
+                            if (entry == 0) {
+                                entry = i + 1;
+                                break;
+                            }
+                            const auto other = static_cast<std::size_t>((entry & ~duplicate_bit) - 1);
+                            if (hashes[other] == hashes[i] && eq(first[other], first[i])) {
+                                entry |= duplicate_bit;
+                                break;
+                            }
+                            slot = (slot + 1) & mask;
+                        }
+                    }
+
+                    for (const auto entry : table) {
+                        if (entry != 0 && !(entry & duplicate_bit)) flags[static_cast<std::size_t>(entry - 1)] = 1;
+                    }
+                });
+
+                return flags;
+            }
+
+            //! Copies the elements whose flag is set to dest in their original order
+            template<typename RandomIt, typename OutputIt>
+            OutputIt _copy_flagged(RandomIt first, const std::vector<char> &flags, OutputIt dest) {
+                for (std::size_t i = 0; i < flags.size(); ++i) {
+                    if (flags[i]) *dest++ = first[i];
                 }
+                return dest;
+            }
+        }
 
-                //! No-op, function is provided to satisfy the requirements of OutputIterator
-                _output_iterator_adapter &operator*() { return *this; }
+        //! Copies the elements of the range that are not equal to any other element of the range to dest in their original order, counts the elements in a hash table instead of requiring sorted input like strict_unique_copy
+        template<typename RandomIt, typename OutputIt, typename Hash, typename KeyEqual>
+        OutputIt strict_unique_unordered(RandomIt first, RandomIt last, OutputIt dest, Hash hash, KeyEqual eq) {
+            const auto flags = _detail::_unique_flags(first, last, hash, eq, 1, [](std::size_t n, auto &&f) {
+                for (std::size_t i = 0; i < n; ++i) f(i);
+            });
+            return _detail::_copy_flagged(first, flags, dest);
+        }
 
-                //! No-op, function is provided to satisfy the requirements of OutputIterator
-                _output_iterator_adapter &operator++() { return *this; }
+        //! Copies the elements of the range that are not equal to any other element of the range to dest in their original order, counts the elements in a hash table instead of requiring sorted input like strict_unique_copy
+        template<typename RandomIt, typename OutputIt>
+        OutputIt strict_unique_unordered(RandomIt first, RandomIt last, OutputIt dest) {
+            return strict_unique_unordered(first, last, dest, std::hash<typename std::iterator_traits<RandomIt>::value_type>(), std::equal_to<>());
+        }
 
-                //! No-op, function is provided to satisfy the requirements of OutputIterator
-                _output_iterator_adapter &operator++(int) { return *this; }
+        //! Copies the elements of the range that are not equal to any other element of the range to dest in their original order, the elements are hashed in parallel and counted in one hash table per partition of the hash values
+        template<typename RandomIt, typename OutputIt, typename Hash, typename KeyEqual>
+        OutputIt strict_unique_unordered(const parallel_policy &policy, RandomIt first, RandomIt last, OutputIt dest, Hash hash, KeyEqual eq) {
+            const auto flags = _detail::_unique_flags(first, last, hash, eq, policy.chunk_count(), [&policy](std::size_t n, auto &&f) {
+                policy.parallel_for(n, f);
+            });
+            return _detail::_copy_flagged(first, flags, dest);
+        }
+
+        //! Copies the elements of the range that are not equal to any other element of the range to dest in their original order, the elements are hashed in parallel and counted in one hash table per partition of the hash values
+        template<typename RandomIt, typename OutputIt>
+        OutputIt strict_unique_unordered(const parallel_policy &policy, RandomIt first, RandomIt last, OutputIt dest) {
+            return strict_unique_unordered(policy, first, last, dest, std::hash<typename std::iterator_traits<RandomIt>::value_type>(), std::equal_to<>());
+        }
+
+        namespace _detail {
+            //! Checks whether the range of the iterator can be processed by the loops specialized for contiguous arithmetic data
+            template<typename It>
+            using _is_vectorizable = conjunction<std::is_arithmetic<typename std::iterator_traits<It>::value_type>, _is_contiguous_iterator<It>>;
+
+            //! Calls f(run_first, run_length) for every run of consecutive elements that are equal according to p
+            template<typename ForwardIt, typename BinaryPredicate, typename Func>
+            void _for_each_run(ForwardIt first, ForwardIt last, BinaryPredicate p, Func &f, std::false_type /* vectorizable */) {
+                if (first == last) return;
+
+                ForwardIt run_first = first;
+                std::size_t run_length = 1;
+                for (++first; first != last; ++first) {
+                    if (p(*run_first, *first)) {
+                        run_length++;
+                    } else {
+                        f(run_first, run_length);
+                        run_first = first;
+                        run_length = 1;
+                    }
+                }
+                f(run_first, run_length);
+            }
+
+            //! Calls f(run_first, run_length) for every run of consecutive equal elements, compares blocks of elements in loops without early exit that the compiler can vectorize
+            template<typename RandomIt, typename BinaryPredicate, typename Func>
+            void _for_each_run(RandomIt first, RandomIt last, BinaryPredicate, Func &f, std::true_type /* vectorizable */) {
+                if (first == last) return;
+
+                constexpr std::size_t block_size = 256;
+                const auto *data = std::addressof(*first);
+                const auto n = static_cast<std::size_t>(std::distance(first, last));
+
+                unsigned char run_ends[block_size];
+                std::size_t run_first = 0;
+                for (std::size_t block_first = 0; block_first + 1 < n; block_first += block_size) {
+                    const std::size_t block_length = std::min(block_size, n - 1 - block_first);
+                    const auto *block = data + block_first;
+                    for (std::size_t i = 0; i < block_length; ++i) {
+                        run_ends[i] = (block[i] != block[i + 1]);
+                    }
+                    for (std::size_t i = 0; i < block_length; ++i) {
+                        if (run_ends[i]) {
+                            f(std::next(first, run_first), block_first + i + 1 - run_first);
+                            run_first = block_first + i + 1;
+                        }
+                    }
+                }
+                f(std::next(first, run_first), n - run_first);
+            }
+
+            //! Calls f(run_first, run_length) for every run, uses the vectorizable loop for contiguous arithmetic data compared with std::equal_to
+            template<typename ForwardIt, typename BinaryPredicate, typename Func>
+            void _for_each_run(ForwardIt first, ForwardIt last, BinaryPredicate p, Func &f) {
+                using vectorizable = conjunction<std::is_same<BinaryPredicate, std::equal_to<>>, _is_vectorizable<ForwardIt>>;
+                _for_each_run(first, last, p, f, bool_constant<vectorizable::value>());
+            }
+        }
+
+        //! Forward iterator over the runs of consecutive equal elements of a range, dereferences to the iterator_range of the current run
+        template<typename ForwardIt, typename BinaryPredicate = std::equal_to<>>
+        class run_iterator {
+        public:
+            using value_type = iterator_range<ForwardIt>;
+            using reference = value_type;
+            using pointer = void;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            //! Constructs an iterator pointing to the run starting at first, p is used to compare elements for equality
+            run_iterator(ForwardIt first, ForwardIt last, BinaryPredicate p = BinaryPredicate())
+                    : run_first(first), run_last(first), last(last), p{p} {
+                run_last = find_run_end(run_first);
+            }
+
+            //! Returns the range of the current run
+            reference operator*() const {
+                return value_type(run_first, run_last);
+            }
+
+            //! Advances to the next run
+            run_iterator &operator++() {
+                run_first = run_last;
+                run_last = find_run_end(run_first);
+                return *this;
+            }
+
+            //! Advances to the next run
+            run_iterator operator++(int) {
+                auto temp(*this);
+                ++(*this);
+                return temp;
+            }
+
+            bool operator==(const run_iterator &other) const { return run_first == other.run_first; }
+
+            bool operator!=(const run_iterator &other) const { return !(*this == other); }
+
+        private:
+            ForwardIt find_run_end(ForwardIt it) const {
+                const auto &equal = p.callable;
+                return find_unequal_successor(it, last, [&equal](const auto &a, const auto &b) { return !equal(a, b); });
+            }
+
+            ForwardIt run_first;
+            ForwardIt run_last;
+            ForwardIt last;
+            callable_container<BinaryPredicate> p;
+        };
+
+        //! Returns a lazy range over the runs of consecutive equal elements of the specified range, every run is represented by its iterator_range
+        template<typename ForwardIt>
+        iterator_range<run_iterator<ForwardIt>> runs(ForwardIt first, ForwardIt last) {
+            return iterator_range<run_iterator<ForwardIt>>(run_iterator<ForwardIt>(first, last), run_iterator<ForwardIt>(last, last));
+        }
+
+        //! Returns a lazy range over the runs of consecutive equal elements of the specified range, uses p to compare elements for equality
+        template<typename ForwardIt, typename BinaryPredicate>
+        iterator_range<run_iterator<ForwardIt, BinaryPredicate>> runs(ForwardIt first, ForwardIt last, BinaryPredicate p) {
+            using iterator_type = run_iterator<ForwardIt, BinaryPredicate>;
+            return iterator_range<iterator_type>(iterator_type(first, last, p), iterator_type(last, last, p));
+        }
+
+        //! Writes the value and the length of every run of consecutive equal elements to values and counts, uses p to compare elements for equality
+        template<typename ForwardIt, typename ValueOutputIt, typename CountOutputIt, typename BinaryPredicate>
+        std::pair<ValueOutputIt, CountOutputIt> run_length_encode(ForwardIt first, ForwardIt last, ValueOutputIt values, CountOutputIt counts, BinaryPredicate p) {
+            auto emit = [&](ForwardIt run_first, std::size_t run_length) {
+                *values++ = *run_first;
+                *counts++ = run_length;
+            };
+            _detail::_for_each_run(first, last, p, emit);
+            return {values, counts};
+        }
+
+        //! Writes the value and the length of every run of consecutive equal elements to values and counts, uses equal operator for comparison
+        template<typename ForwardIt, typename ValueOutputIt, typename CountOutputIt>
+        std::pair<ValueOutputIt, CountOutputIt> run_length_encode(ForwardIt first, ForwardIt last, ValueOutputIt values, CountOutputIt counts) {
+            return run_length_encode(first, last, values, counts, std::equal_to<>());
+        }
+
+        //! Writes the value and the length of every run of consecutive equal elements to values and counts in parallel, uses p to compare elements for equality
+        template<typename ForwardIt, typename ValueOutputIt, typename CountOutputIt, typename BinaryPredicate>
+        std::pair<ValueOutputIt, CountOutputIt> run_length_encode(const parallel_policy &policy, ForwardIt first, ForwardIt last,
+                                                                  ValueOutputIt values, CountOutputIt counts, BinaryPredicate p) {
+            std::vector<ForwardIt> bounds;
+            n_subranges(first, last, std::back_inserter(bounds), policy.chunk_count());
+            if (bounds.empty()) return {values, counts};
+
+            // Encode every chunk separately, runs spanning chunk boundaries are joined afterwards
+            std::vector<std::vector<std::pair<ForwardIt, std::size_t>>> chunk_runs(bounds.size() - 1);
+            policy.parallel_for(chunk_runs.size(), [&](std::size_t i) {
+                auto collect = [&](ForwardIt run_first, std::size_t run_length) {
+                    chunk_runs[i].emplace_back(run_first, run_length);
+                };
+                _detail::_for_each_run(bounds[i], bounds[i + 1], p, collect);
+            });
+
+            auto run = chunk_runs.front().front();
+            for (std::size_t i = 0; i < chunk_runs.size(); ++i) {
+                for (std::size_t j = (i == 0) ? 1 : 0; j < chunk_runs[i].size(); ++j) {
+                    const auto &next = chunk_runs[i][j];
+                    if (j == 0 && p(*run.first, *next.first)) {
+                        run.second += next.second;
+                    } else {
+                        *values++ = *run.first;
+                        *counts++ = run.second;
+                        run = next;
+                    }
+                }
+            }
+            *values++ = *run.first;
+            *counts++ = run.second;
+
+            return {values, counts};
+        }
+
+        //! Writes the value and the length of every run of consecutive equal elements to values and counts in parallel, uses equal operator for comparison
+        template<typename ForwardIt, typename ValueOutputIt, typename CountOutputIt>
+        std::pair<ValueOutputIt, CountOutputIt> run_length_encode(const parallel_policy &policy, ForwardIt first, ForwardIt last,
+                                                                  ValueOutputIt values, CountOutputIt counts) {
+            return run_length_encode(policy, first, last, values, counts, std::equal_to<>());
+        }
+
+        //! Writes every value of the specified range to dest repeated by the corresponding entry of counts, inverse of run_length_encode
+        template<typename InputIt, typename CountInputIt, typename OutputIt>
+        OutputIt run_length_decode(InputIt values_first, InputIt values_last, CountInputIt counts, OutputIt dest) {
+            for (; values_first != values_last; ++values_first, ++counts) {
+                dest = std::fill_n(dest, *counts, *values_first);
+            }
+            return dest;
+        }
+
+        //! Writes every value of the specified range to dest repeated by the corresponding entry of counts in parallel, inverse of run_length_encode
+        template<typename ForwardIt, typename CountRandomIt, typename RandomIt>
+        RandomIt run_length_decode(const parallel_policy &policy, ForwardIt values_first, ForwardIt values_last, CountRandomIt counts, RandomIt dest) {
+            const auto n_runs = static_cast<std::size_t>(std::distance(values_first, values_last));
+            if (n_runs == 0) return dest;
+
+            // Output offsets of the runs, the chunks are balanced by the number of written elements
+            std::vector<std::size_t> run_ends(n_runs);
+            std::partial_sum(counts, counts + n_runs, run_ends.begin());
+
+            std::vector<ForwardIt> bounds;
+            n_subranges_weighted_cumulative(values_first, values_last, std::back_inserter(bounds), policy.chunk_count(), run_ends.begin());
+
+            policy.parallel_for(bounds.size() - 1, [&](std::size_t i) {
+                const auto run_first = static_cast<std::size_t>(std::distance(values_first, bounds[i]));
+                const auto output_first = (run_first > 0) ? run_ends[run_first - 1] : 0;
+                run_length_decode(bounds[i], bounds[i + 1], counts + run_first, dest + output_first);
+            });
+
+            return dest + run_ends.back();
+        }
+
+        namespace _detail {
+            //! Maps values of arithmetic types to unsigned integer keys with the same order, value is false if the type is not supported by radix_sort
+            template<typename T, typename = void>
+            struct _radix_traits : std::false_type {
+            };
+
+            template<typename T>
+            struct _radix_traits<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+                    : std::true_type {
+                using key_type = std::make_unsigned_t<T>;
+
+                static key_type key(T value) {
+                    // Flipping the sign bit moves negative values in front of positive values
+                    const key_type sign = std::is_signed<T>::value ? key_type(key_type(1) << (8 * sizeof(T) - 1)) : key_type(0);
+                    return key_type(static_cast<key_type>(value) ^ sign);
+                }
             };
+
+            template<typename T>
+            struct _radix_traits<T, std::enable_if_t<std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559
+                                                     && (sizeof(T) == 4 || sizeof(T) == 8)>>
+                    : std::true_type {
+                using key_type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+                static key_type key(T value) {
+                    key_type bits;
+                    std::memcpy(&bits, &value, sizeof(T));
+                    // Negative values are ordered in reverse by their bit pattern and have to be placed in front of positive values
+                    const key_type sign = key_type(1) << (8 * sizeof(T) - 1);
+                    return (bits & sign) ? key_type(~bits) : key_type(bits | sign);
+                }
+            };
+
+            //! Performs one stable counting sort pass on the specified byte of the keys from src to dst, returns false without moving any element if all elements have the same byte
+            template<typename SrcIt, typename DstIt, typename ForEachChunk>
+            bool _radix_sort_pass(SrcIt src, DstIt dst, const std::vector<std::size_t> &bounds,
+                                  std::vector<std::array<std::size_t, 256>> &offsets, unsigned shift, ForEachChunk &for_each_chunk) {
+                using traits = _radix_traits<typename std::iterator_traits<SrcIt>::value_type>;
+                const auto digit = [shift](const auto &value) {
+                    return static_cast<std::size_t>((traits::key(value) >> shift) & 0xff);
+                };
+                const std::size_t n_chunks = bounds.size() - 1;
+
+                // Histogram of the digits per chunk
+                for_each_chunk(n_chunks, [&](std::size_t c) {
+                    auto &histogram = offsets[c];
+                    histogram.fill(0);
+                    for (std::size_t i = bounds[c]; i < bounds[c + 1]; ++i) ++histogram[digit(src[i])];
+                });
+
+                // Skip the pass if all elements have the same digit
+                for (std::size_t d = 0; d < 256; ++d) {
+                    std::size_t count = 0;
+                    for (std::size_t c = 0; c < n_chunks; ++c) count += offsets[c][d];
+                    if (count == bounds.back()) return false;
+                    if (count != 0) break;
+                }
+
+                // Convert the counts to the output offsets of every chunk and digit, ordering the chunks within a digit keeps the sort stable
+                std::size_t offset = 0;
+                for (std::size_t d = 0; d < 256; ++d) {
+                    for (std::size_t c = 0; c < n_chunks; ++c) {
+                        const std::size_t count = offsets[c][d];
+                        offsets[c][d] = offset;
+                        offset += count;
+                    }
+                }
+
+                for_each_chunk(n_chunks, [&](std::size_t c) {
+                    auto &chunk_offsets = offsets[c];
+                    for (std::size_t i = bounds[c]; i < bounds[c + 1]; ++i) {
+                        dst[chunk_offsets[digit(src[i])]++] = std::move(src[i]);
+                    }
+                });
+                return true;
+            }
+
+            //! LSD radix sort with 8 bit digits, for_each_chunk(n, f) has to call f(i) for every i in [0, n)
+            template<typename RandomIt, typename ForEachChunk>
+            void _radix_sort(RandomIt first, RandomIt last, std::size_t n_chunks, ForEachChunk for_each_chunk) {
+                using value_t = typename std::iterator_traits<RandomIt>::value_type;
+                static_assert(_radix_traits<value_t>::value,
+                              "Error: radix_sort only supports integral types and floating point types with 32 or 64 bit!");
+
+                const auto n = static_cast<std::size_t>(std::distance(first, last));
+                if (n < 2) return;
+
+                n_chunks = std::max<std::size_t>(1, std::min(n_chunks, n));
+                std::vector<std::size_t> bounds(n_chunks + 1);
+                for (std::size_t c = 0; c <= n_chunks; ++c) bounds[c] = n * c / n_chunks;
+
+                std::vector<std::array<std::size_t, 256>> offsets(n_chunks);
+                std::vector<value_t> buffer(n);
+
+                // The elements alternate between the input range and the buffer
+                bool in_buffer = false;
+                for (unsigned pass = 0; pass < sizeof(typename _radix_traits<value_t>::key_type); ++pass) {
+                    const bool moved = in_buffer
+                                       ? _radix_sort_pass(buffer.begin(), first, bounds, offsets, 8 * pass, for_each_chunk)
+                                       : _radix_sort_pass(first, buffer.begin(), bounds, offsets, 8 * pass, for_each_chunk);
+                    if (moved) in_buffer = !in_buffer;
+                }
+
+                if (in_buffer) {
+                    for_each_chunk(n_chunks, [&](std::size_t c) {
+                        std::move(buffer.begin() + bounds[c], buffer.begin() + bounds[c + 1], first + bounds[c]);
+                    });
+                }
+            }
         }
 
-        //! Returns an OutputIterator like type which forwards output assignments to the supplied callable.
+        //! Sorts integral or floating point values with up to 64 bit in ascending order using a LSD radix sort
         /*
-        * Construction, copy construction, destruction etc. of the callable may not have any side effects.
-        */
-        template<typename Func>
-        auto make_output_iterator_adapter(Func f) {
-            return _detail::_output_iterator_adapter<typename std::decay<Func>::type>{std::forward<Func>(f)};
+         * Negative zero is ordered in front of positive zero and NaNs are ordered at the ends of the range according to their sign bit.
+         */
+        template<typename RandomIt>
+        void radix_sort(RandomIt first, RandomIt last) {
+            _detail::_radix_sort(first, last, 1, [](std::size_t n, auto &&f) {
+                for (std::size_t i = 0; i < n; ++i) f(i);
+            });
+        }
+
+        //! Sorts integral or floating point values with up to 64 bit in ascending order using a LSD radix sort with parallel histogram and scatter steps
+        template<typename RandomIt>
+        void radix_sort(const parallel_policy &policy, RandomIt first, RandomIt last) {
+            _detail::_radix_sort(first, last, policy.chunk_count(), [&policy](std::size_t n, auto &&f) {
+                policy.parallel_for(n, f);
+            });
+        }
+
+        namespace _detail {
+            //! Returns how many elements of a are among the first diag elements of the stable merge of a and b, i.e. where the merge path crosses the diagonal diag
+            template<typename RandomIt1, typename RandomIt2, typename Compare>
+            std::size_t _merge_path_split(RandomIt1 a, std::size_t na, RandomIt2 b, std::size_t nb, std::size_t diag, Compare &comp) {
+                std::size_t lo = (diag > nb) ? diag - nb : 0;
+                std::size_t hi = std::min(diag, na);
+                while (lo < hi) {
+                    const std::size_t mid = lo + (hi - lo) / 2;
+                    // Elements of a precede equal elements of b in a stable merge
+                    if (!comp(b[diag - mid - 1], a[mid])) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                return lo;
+            }
+
+            //! Sorts the chunks of the range concurrently and merges pairs of sorted runs until one run is left, every merge is split along its merge path
+            template<typename RandomIt, typename Compare>
+            void _parallel_merge_sort(const parallel_policy &policy, RandomIt first, RandomIt last, Compare &comp, bool stable) {
+                using value_t = typename std::iterator_traits<RandomIt>::value_type;
+                static_assert(std::is_default_constructible<value_t>::value,
+                              "Error: The parallel sorts require default constructible value types for the merge buffer!");
+
+                const auto n = static_cast<std::size_t>(std::distance(first, last));
+                const std::size_t n_chunks = std::min(policy.chunk_count(), n);
+                if (n_chunks < 2) {
+                    if (stable) std::stable_sort(first, last, comp);
+                    else std::sort(first, last, comp);
+                    return;
+                }
+
+                std::vector<std::size_t> runs(n_chunks + 1);
+                for (std::size_t c = 0; c <= n_chunks; ++c) runs[c] = n * c / n_chunks;
+
+                policy.parallel_for(n_chunks, [&](std::size_t c) {
+                    if (stable) std::stable_sort(first + runs[c], first + runs[c + 1], comp);
+                    else std::sort(first + runs[c], first + runs[c + 1], comp);
+                });
+
+                // Every merge of two runs is divided into parts of equal output size, their number is proportional to the size of the merge
+                struct merge_task {
+                    std::size_t first, middle, last, diag_first, diag_last, a_first, a_last;
+                };
+
+                const std::unique_ptr<value_t[]> buffer(new value_t[n]);
+                bool in_buffer = false;
+                std::vector<merge_task> tasks;
+                while (runs.size() > 2) {
+                    tasks.clear();
+                    std::vector<std::size_t> merged_runs;
+                    for (std::size_t r = 0; r + 1 < runs.size(); r += 2) {
+                        // A run without partner is moved unchanged
+                        const std::size_t middle = runs[r + 1];
+                        const std::size_t run_last = (r + 2 < runs.size()) ? runs[r + 2] : middle;
+                        const std::size_t n_parts = std::max<std::size_t>(1, n_chunks * (run_last - runs[r]) / n);
+                        const std::size_t n_merged = run_last - runs[r];
+                        for (std::size_t part = 0; part < n_parts; ++part) {
+                            tasks.push_back(merge_task{runs[r], middle, run_last, n_merged * part / n_parts,
+                                                       n_merged * (part + 1) / n_parts, 0, 0});
+                        }
+                        merged_runs.push_back(runs[r]);
+                    }
+                    merged_runs.push_back(n);
+
+                    const auto merge_round = [&](auto src, auto dst) {
+                        // All split points have to be found before the merges start moving elements out of src
+                        policy.parallel_for(tasks.size(), [&](std::size_t t) {
+                            auto &task = tasks[t];
+                            const std::size_t na = task.middle - task.first;
+                            const std::size_t nb = task.last - task.middle;
+                            task.a_first = _merge_path_split(src + task.first, na, src + task.middle, nb, task.diag_first, comp);
+                            task.a_last = _merge_path_split(src + task.first, na, src + task.middle, nb, task.diag_last, comp);
+                        });
+                        policy.parallel_for(tasks.size(), [&](std::size_t t) {
+                            const auto &task = tasks[t];
+                            const auto a = src + task.first;
+                            const auto b = src + task.middle;
+                            std::merge(std::make_move_iterator(a + task.a_first), std::make_move_iterator(a + task.a_last),
+                                       std::make_move_iterator(b + (task.diag_first - task.a_first)),
+                                       std::make_move_iterator(b + (task.diag_last - task.a_last)),
+                                       dst + task.first + task.diag_first, comp);
+                        });
+                    };
+                    if (in_buffer) merge_round(buffer.get(), first);
+                    else merge_round(first, buffer.get());
+
+                    in_buffer = !in_buffer;
+                    runs = std::move(merged_runs);
+                }
+
+                if (in_buffer) {
+                    policy.parallel_for(n_chunks, [&](std::size_t c) {
+                        const std::size_t chunk_first = n * c / n_chunks;
+                        const std::size_t chunk_last = n * (c + 1) / n_chunks;
+                        std::move(buffer.get() + chunk_first, buffer.get() + chunk_last, first + chunk_first);
+                    });
+                }
+            }
+        }
+
+        //! Sorts the range in parallel using comp, the chunks of the range are sorted concurrently and combined by parallel merges split along their merge paths
+        template<typename RandomIt, typename Compare = std::less<>>
+        void parallel_sort(const parallel_policy &policy, RandomIt first, RandomIt last, Compare comp = Compare()) {
+            _detail::_parallel_merge_sort(policy, first, last, comp, false);
+        }
+
+        //! Sorts the range in parallel using comp and preserves the order of equal elements
+        template<typename RandomIt, typename Compare = std::less<>>
+        void parallel_stable_sort(const parallel_policy &policy, RandomIt first, RandomIt last, Compare comp = Compare()) {
+            _detail::_parallel_merge_sort(policy, first, last, comp, true);
+        }
+
+        //! Minimum number of elements for which the parallel sorted_vector uses radix_sort instead of std::sort for integral and floating point types
+        NONAME_INLINE_VARIABLE constexpr std::size_t radix_sort_threshold = 2048;
+
+        namespace _detail {
+            //! Sorts the vector with the parallel radix_sort if it is large enough
+            template<typename T, typename Allocator>
+            void _sort_vector(const parallel_policy &policy, std::vector<T, Allocator> &vector, std::true_type /* radix sortable */) {
+                if (vector.size() < radix_sort_threshold) {
+                    std::sort(vector.begin(), vector.end());
+                } else {
+                    radix_sort(policy, vector.begin(), vector.end());
+                }
+            }
+
+            //! Sorts the vector with parallel_sort
+            template<typename T, typename Allocator>
+            void _sort_vector(const parallel_policy &policy, std::vector<T, Allocator> &vector, std::false_type /* radix sortable */) {
+                parallel_sort(policy, vector.begin(), vector.end());
+            }
+        }
+
+        //! Sorts the supplied r-value vector in parallel and returns it, uses radix_sort for large vectors of integral and floating point types
+        template<typename T, typename Allocator>
+        std::vector<T, Allocator> sorted_vector(const parallel_policy &policy, std::vector<T, Allocator> &&vector) {
+            _detail::_sort_vector(policy, vector, bool_constant<_detail::_radix_traits<T>::value>());
+            return vector;
+        }
+
+        //! Sorts the supplied r-value vector in parallel using comp and returns it
+        template<typename T, typename Allocator, typename Compare>
+        std::vector<T, Allocator> sorted_vector(const parallel_policy &policy, std::vector<T, Allocator> &&vector, Compare comp) {
+            parallel_sort(policy, vector.begin(), vector.end(), comp);
+            return vector;
+        }
+
+        namespace _detail {
+            //! Inputs whose size ratio exceeds this value are combined by galloping through the larger input
+            constexpr std::size_t _gallop_ratio = 32;
+
+            //! Returns the first element in [first, last) that is not less than value using an exponential search starting at first
+            template<typename RandomIt, typename T, typename Compare>
+            RandomIt _gallop_lower_bound(RandomIt first, RandomIt last, const T &value, Compare &comp) {
+                const auto n = std::distance(first, last);
+                if (n == 0 || !comp(first[0], value)) return first;
+
+                // The element at prev is always less than the value
+                std::ptrdiff_t prev = 0;
+                std::ptrdiff_t step = 1;
+                while (prev + step < n && comp(first[prev + step], value)) {
+                    prev += step;
+                    step *= 2;
+                }
+                return std::lower_bound(first + prev + 1, first + std::min(prev + step, n), value, comp);
+            }
+
+            //! Checks whether both ranges can be combined by the branchless loops for contiguous arithmetic data
+            template<typename RandomIt1, typename RandomIt2, typename Compare>
+            using _is_branchless_mergeable = conjunction<std::is_same<Compare, std::less<>>, _is_vectorizable<RandomIt1>, _is_vectorizable<RandomIt2>,
+                    std::is_same<typename std::iterator_traits<RandomIt1>::value_type, typename std::iterator_traits<RandomIt2>::value_type>>;
+
+            //! Merges contiguous arithmetic ranges without branches, step(x, y, out) writes the output for the current pair to out and returns the number of output elements
+            template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Step>
+            OutputIt _branchless_merge(RandomIt1 &first1, RandomIt1 last1, RandomIt2 &first2, RandomIt2 last2, OutputIt dest, Step step) {
+                using value_t = typename std::iterator_traits<RandomIt1>::value_type;
+                constexpr std::size_t block_size = 64;
+
+                if (first1 == last1 || first2 == last2) return dest;
+                const value_t *a = std::addressof(*first1);
+                const value_t *b = std::addressof(*first2);
+                const auto na = static_cast<std::size_t>(std::distance(first1, last1));
+                const auto nb = static_cast<std::size_t>(std::distance(first2, last2));
+
+                // Outputs are collected in a local block, every iteration advances at least one of the inputs
+                value_t block[block_size];
+                std::size_t i = 0, j = 0;
+                while (i < na && j < nb) {
+                    const std::size_t n_steps = std::min(block_size, std::min(na - i, nb - j));
+                    std::size_t k = 0;
+                    for (std::size_t s = 0; s < n_steps; ++s) {
+                        const value_t x = a[i];
+                        const value_t y = b[j];
+                        k += step(x, y, block + k);
+                        i += (x <= y);
+                        j += (y <= x);
+                    }
+                    dest = std::copy(block, block + k, dest);
+                }
+
+                first1 = std::next(first1, i);
+                first2 = std::next(first2, j);
+                return dest;
+            }
+
+            template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+            OutputIt _similar_set_intersection(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare &, std::true_type) {
+                return _branchless_merge(first1, last1, first2, last2, dest, [](auto x, auto y, auto *out) {
+                    *out = x;
+                    return std::size_t(x == y);
+                });
+            }
+
+            template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+            OutputIt _similar_set_intersection(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare &comp, std::false_type) {
+                return std::set_intersection(first1, last1, first2, last2, dest, comp);
+            }
+
+            template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+            OutputIt _similar_set_union(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare &, std::true_type) {
+                dest = _branchless_merge(first1, last1, first2, last2, dest, [](auto x, auto y, auto *out) {
+                    *out = (y < x) ? y : x;
+                    return std::size_t(1);
+                });
+                return std::copy(first2, last2, std::copy(first1, last1, dest));
+            }
+
+            template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+            OutputIt _similar_set_union(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare &comp, std::false_type) {
+                return std::set_union(first1, last1, first2, last2, dest, comp);
+            }
+
+            template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+            OutputIt _similar_set_difference(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare &, std::true_type) {
+                dest = _branchless_merge(first1, last1, first2, last2, dest, [](auto x, auto y, auto *out) {
+                    *out = x;
+                    return std::size_t(x < y);
+                });
+                return std::copy(first1, last1, dest);
+            }
+
+            template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+            OutputIt _similar_set_difference(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare &comp, std::false_type) {
+                return std::set_difference(first1, last1, first2, last2, dest, comp);
+            }
+        }
+
+        //! Copies the elements of the sorted range 1 that are also found in the sorted range 2 to dest like std::set_intersection using comp, gallops through the larger range if the sizes differ considerably
+        template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+        OutputIt adaptive_set_intersection(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare comp) {
+            const auto n1 = static_cast<std::size_t>(std::distance(first1, last1));
+            const auto n2 = static_cast<std::size_t>(std::distance(first2, last2));
+
+            if (n1 * _detail::_gallop_ratio < n2) {
+                for (; first1 != last1; ++first1) {
+                    first2 = _detail::_gallop_lower_bound(first2, last2, *first1, comp);
+                    if (first2 == last2) break;
+                    if (!comp(*first1, *first2)) {
+                        *dest++ = *first1;
+                        ++first2;
+                    }
+                }
+                return dest;
+            }
+
+            if (n2 * _detail::_gallop_ratio < n1) {
+                for (; first2 != last2; ++first2) {
+                    first1 = _detail::_gallop_lower_bound(first1, last1, *first2, comp);
+                    if (first1 == last1) break;
+                    if (!comp(*first2, *first1)) {
+                        *dest++ = *first1;
+                        ++first1;
+                    }
+                }
+                return dest;
+            }
+
+            return _detail::_similar_set_intersection(first1, last1, first2, last2, dest, comp,
+                                                      bool_constant<_detail::_is_branchless_mergeable<RandomIt1, RandomIt2, Compare>::value>());
+        }
+
+        //! Copies the elements of the sorted range 1 that are also found in the sorted range 2 to dest like std::set_intersection, gallops through the larger range if the sizes differ considerably
+        template<typename RandomIt1, typename RandomIt2, typename OutputIt>
+        OutputIt adaptive_set_intersection(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest) {
+            return adaptive_set_intersection(first1, last1, first2, last2, dest, std::less<>());
+        }
+
+        //! Copies the elements found in either of the sorted ranges to dest like std::set_union using comp, gallops through the larger range if the sizes differ considerably
+        template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+        OutputIt adaptive_set_union(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare comp) {
+            const auto n1 = static_cast<std::size_t>(std::distance(first1, last1));
+            const auto n2 = static_cast<std::size_t>(std::distance(first2, last2));
+
+            if (n1 * _detail::_gallop_ratio < n2) {
+                for (; first1 != last1; ++first1) {
+                    const auto bound = _detail::_gallop_lower_bound(first2, last2, *first1, comp);
+                    dest = std::copy(first2, bound, dest);
+                    first2 = bound;
+                    *dest++ = *first1;
+                    if (first2 != last2 && !comp(*first1, *first2)) ++first2;
+                }
+                return std::copy(first2, last2, dest);
+            }
+
+            if (n2 * _detail::_gallop_ratio < n1) {
+                for (; first2 != last2; ++first2) {
+                    const auto bound = _detail::_gallop_lower_bound(first1, last1, *first2, comp);
+                    dest = std::copy(first1, bound, dest);
+                    first1 = bound;
+                    // Equivalent elements are copied from range 1
+                    if (first1 != last1 && !comp(*first2, *first1)) {
+                        *dest++ = *first1++;
+                    } else {
+                        *dest++ = *first2;
+                    }
+                }
+                return std::copy(first1, last1, dest);
+            }
+
+            return _detail::_similar_set_union(first1, last1, first2, last2, dest, comp,
+                                               bool_constant<_detail::_is_branchless_mergeable<RandomIt1, RandomIt2, Compare>::value>());
+        }
+
+        //! Copies the elements found in either of the sorted ranges to dest like std::set_union, gallops through the larger range if the sizes differ considerably
+        template<typename RandomIt1, typename RandomIt2, typename OutputIt>
+        OutputIt adaptive_set_union(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest) {
+            return adaptive_set_union(first1, last1, first2, last2, dest, std::less<>());
+        }
+
+        //! Copies the elements of the sorted range 1 that are not found in the sorted range 2 to dest like std::set_difference using comp, gallops through the larger range if the sizes differ considerably
+        template<typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+        OutputIt adaptive_set_difference(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest, Compare comp) {
+            const auto n1 = static_cast<std::size_t>(std::distance(first1, last1));
+            const auto n2 = static_cast<std::size_t>(std::distance(first2, last2));
+
+            if (n1 * _detail::_gallop_ratio < n2) {
+                for (; first1 != last1; ++first1) {
+                    first2 = _detail::_gallop_lower_bound(first2, last2, *first1, comp);
+                    if (first2 != last2 && !comp(*first1, *first2)) {
+                        ++first2;
+                    } else {
+                        *dest++ = *first1;
+                    }
+                }
+                return dest;
+            }
+
+            if (n2 * _detail::_gallop_ratio < n1) {
+                for (; first2 != last2; ++first2) {
+                    const auto bound = _detail::_gallop_lower_bound(first1, last1, *first2, comp);
+                    dest = std::copy(first1, bound, dest);
+                    first1 = bound;
+                    if (first1 != last1 && !comp(*first2, *first1)) ++first1;
+                }
+                return std::copy(first1, last1, dest);
+            }
+
+            return _detail::_similar_set_difference(first1, last1, first2, last2, dest, comp,
+                                                    bool_constant<_detail::_is_branchless_mergeable<RandomIt1, RandomIt2, Compare>::value>());
+        }
+
+        //! Copies the elements of the sorted range 1 that are not found in the sorted range 2 to dest like std::set_difference, gallops through the larger range if the sizes differ considerably
+        template<typename RandomIt1, typename RandomIt2, typename OutputIt>
+        OutputIt adaptive_set_difference(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt dest) {
+            return adaptive_set_difference(first1, last1, first2, last2, dest, std::less<>());
+        }
+
+        //! Copies the elements found in all of the sorted ranges to dest using comp, the candidates from the smallest range are searched by galloping through the other ranges
+        template<typename RandomIt, typename OutputIt, typename Compare>
+        OutputIt multiway_set_intersection(const std::vector<iterator_range<RandomIt>> &ranges, OutputIt dest, Compare comp) {
+            if (ranges.empty()) return dest;
+
+            // Cursors into the ranges ordered by size, candidates are taken from the smallest range
+            std::vector<iterator_range<RandomIt>> cursors(ranges);
+            std::sort(cursors.begin(), cursors.end(), [](const auto &a, const auto &b) { return a.size() < b.size(); });
+            std::vector<RandomIt> positions;
+            for (const auto &range : cursors) positions.push_back(range.begin());
+
+            auto candidate = cursors[0].begin();
+            const auto candidates_end = cursors[0].end();
+            while (candidate != candidates_end) {
+                bool found = true;
+                for (std::size_t k = 1; k < cursors.size(); ++k) {
+                    positions[k] = _detail::_gallop_lower_bound(positions[k], cursors[k].end(), *candidate, comp);
+                    if (positions[k] == cursors[k].end()) return dest;
+                    // Skip all candidates smaller than the next element of this range
+                    if (comp(*candidate, *positions[k])) {
+                        candidate = _detail::_gallop_lower_bound(candidate, candidates_end, *positions[k], comp);
+                        found = false;
+                        break;
+                    }
+                }
+
+                if (found) {
+                    *dest++ = *candidate++;
+                    for (std::size_t k = 1; k < cursors.size(); ++k) ++positions[k];
+                }
+            }
+            return dest;
+        }
+
+        //! Copies the elements found in all of the sorted ranges to dest, the candidates from the smallest range are searched by galloping through the other ranges
+        template<typename RandomIt, typename OutputIt>
+        OutputIt multiway_set_intersection(const std::vector<iterator_range<RandomIt>> &ranges, OutputIt dest) {
+            return multiway_set_intersection(ranges, dest, std::less<>());
+        }
+
+        //! Merges the sorted ranges 1 and 2 into dest using comp like std::merge, the output is divided into equally sized parts along the merge path which are merged concurrently
+        template<typename RandomIt1, typename RandomIt2, typename RandomIt3, typename Compare = std::less<>>
+        RandomIt3 parallel_merge(const parallel_policy &policy, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2,
+                                 RandomIt3 dest, Compare comp = Compare()) {
+            const auto n1 = static_cast<std::size_t>(std::distance(first1, last1));
+            const auto n2 = static_cast<std::size_t>(std::distance(first2, last2));
+            const std::size_t n = n1 + n2;
+            const std::size_t n_parts = std::min(policy.chunk_count(), n);
+
+            policy.parallel_for(n_parts, [&](std::size_t part) {
+                const std::size_t diag_first = n * part / n_parts;
+                const std::size_t diag_last = n * (part + 1) / n_parts;
+                const std::size_t a_first = _detail::_merge_path_split(first1, n1, first2, n2, diag_first, comp);
+                const std::size_t a_last = _detail::_merge_path_split(first1, n1, first2, n2, diag_last, comp);
+                std::merge(first1 + a_first, first1 + a_last, first2 + (diag_first - a_first), first2 + (diag_last - a_last),
+                           dest + diag_first, comp);
+            });
+
+            return dest + n;
+        }
+
+        namespace _detail {
+            //! Tournament tree of losers used for k-way merging, every inner node stores the index of the input that lost the comparison at this node
+            template<typename RandomIt, typename Compare>
+            class _loser_tree {
+            public:
+                _loser_tree(std::vector<RandomIt> &positions, const std::vector<RandomIt> &ends, Compare &comp)
+                        : positions(positions), ends(ends), comp(comp), k(positions.size()), nodes(std::max<std::size_t>(k, 1)) {
+                    if (k == 0) return;
+                    // Play the initial tournament bottom up, winners are only needed during construction
+                    std::vector<std::size_t> winners(k);
+                    const auto winner_of = [&](std::size_t node) { return (node >= k) ? node - k : winners[node]; };
+                    for (std::size_t node = k - 1; node >= 1; --node) {
+                        const std::size_t left = winner_of(2 * node);
+                        const std::size_t right = winner_of(2 * node + 1);
+                        winners[node] = beats(left, right) ? left : right;
+                        nodes[node] = beats(left, right) ? right : left;
+                    }
+                    nodes[0] = (k == 1) ? 0 : winners[1];
+                }
+
+                //! Returns the index of the input with the smallest current element
+                std::size_t winner() const { return nodes[0]; }
+
+                //! Advances the winning input and replays its path to the root
+                void advance() {
+                    std::size_t candidate = nodes[0];
+                    ++positions[candidate];
+                    for (std::size_t node = (candidate + k) / 2; node >= 1; node /= 2) {
+                        if (beats(nodes[node], candidate)) std::swap(nodes[node], candidate);
+                    }
+                    nodes[0] = candidate;
+                }
+
+            private:
+                //! Returns whether the current element of input a precedes the one of input b, exhausted inputs lose and ties are won by the lower index
+                bool beats(std::size_t a, std::size_t b) const {
+                    if (positions[a] == ends[a]) return false;
+                    if (positions[b] == ends[b]) return true;
+                    if (comp(*positions[b], *positions[a])) return false;
+                    return comp(*positions[a], *positions[b]) || a < b;
+                }
+
+                std::vector<RandomIt> &positions;
+                const std::vector<RandomIt> &ends;
+                Compare &comp;
+                std::size_t k;
+                std::vector<std::size_t> nodes;
+            };
+
+            //! Merges the ranges [positions[i], ends[i]) into dest using a loser tree, the total number of elements has to be n
+            template<typename RandomIt, typename OutputIt, typename Compare>
+            OutputIt _merge_many(std::vector<RandomIt> positions, const std::vector<RandomIt> &ends, std::size_t n, OutputIt dest, Compare &comp) {
+                _loser_tree<RandomIt, Compare> tree(positions, ends, comp);
+                for (std::size_t i = 0; i < n; ++i) {
+                    *dest++ = *positions[tree.winner()];
+                    tree.advance();
+                }
+                return dest;
+            }
+        }
+
+        //! Merges all sorted ranges into dest using comp, equivalent elements keep the order of their ranges, the output is divided by sampled splitters into parts merged concurrently by loser trees
+        template<typename RandomIt, typename RandomIt2, typename Compare = std::less<>>
+        RandomIt2 parallel_merge_many(const parallel_policy &policy, const std::vector<iterator_range<RandomIt>> &ranges, RandomIt2 dest,
+                                      Compare comp = Compare()) {
+            using value_t = typename std::iterator_traits<RandomIt>::value_type;
+
+            std::size_t n = 0;
+            for (const auto &range : ranges) n += range.size();
+            if (n == 0) return dest;
+            const std::size_t n_parts = std::min(policy.chunk_count(), n);
+
+            // Choose the part splitters from evenly spaced samples of all ranges
+            constexpr std::size_t oversampling = 16;
+            std::vector<value_t> samples;
+            for (const auto &range : ranges) {
+                const std::size_t size = range.size();
+                const std::size_t n_samples = std::min(size, n_parts * oversampling * size / n + 1);
+                for (std::size_t s = 0; s < n_samples; ++s) samples.push_back(range.begin()[size * s / n_samples]);
+            }
+            std::sort(samples.begin(), samples.end(), comp);
+
+            // Every part contains the elements not less than its first splitter and less than the next one
+            std::vector<std::vector<RandomIt>> bounds(n_parts + 1);
+            for (const auto &range : ranges) {
+                bounds.front().push_back(range.begin());
+                bounds.back().push_back(range.end());
+            }
+            for (std::size_t part = 1; part < n_parts; ++part) {
+                const auto &splitter = samples[samples.size() * part / n_parts];
+                for (const auto &range : ranges) {
+                    bounds[part].push_back(std::lower_bound(range.begin(), range.end(), splitter, comp));
+                }
+            }
+
+            std::vector<std::size_t> offsets(n_parts + 1, 0);
+            for (std::size_t part = 0; part < n_parts; ++part) {
+                for (std::size_t r = 0; r < ranges.size(); ++r) {
+                    offsets[part + 1] += static_cast<std::size_t>(std::distance(bounds[part][r], bounds[part + 1][r]));
+                }
+                offsets[part + 1] += offsets[part];
+            }
+
+            policy.parallel_for(n_parts, [&](std::size_t part) {
+                _detail::_merge_many(bounds[part], bounds[part + 1], offsets[part + 1] - offsets[part], dest + offsets[part], comp);
+            });
+
+            return dest + n;
+        }
+
+        namespace _detail {
+            //! Checks whether a chunk fold with op can use the loop with independent accumulators for contiguous arithmetic data
+            template<typename It, typename T, typename BinaryOp>
+            using _is_vectorizable_sum = conjunction<_is_vectorizable<It>, std::is_arithmetic<T>,
+                    disjunction<std::is_same<BinaryOp, std::plus<>>, std::is_same<BinaryOp, std::plus<T>>>>;
+
+            //! Folds the non-empty range with op starting from its first element
+            template<typename T, typename ForwardIt, typename BinaryOp>
+            T _fold_chunk(ForwardIt first, ForwardIt last, BinaryOp &op, std::false_type /* vectorizable sum */) {
+                T acc = *first;
+                for (++first; first != last; ++first) acc = op(std::move(acc), *first);
+                return acc;
+            }
+
+            //! Sums the non-empty contiguous range with independent accumulators which the compiler can keep in vector registers
+            template<typename T, typename ForwardIt, typename BinaryOp>
+            T _fold_chunk(ForwardIt first, ForwardIt last, BinaryOp &, std::true_type /* vectorizable sum */) {
+                constexpr std::size_t lanes = 8;
+                const auto *data = &*first;
+                const auto n = static_cast<std::size_t>(last - first);
+
+                T acc[lanes] = {};
+                std::size_t i = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    for (std::size_t l = 0; l < lanes; ++l) acc[l] += data[i + l];
+                }
+                for (; i < n; ++i) acc[0] += data[i];
+
+                T sum = acc[0];
+                for (std::size_t l = 1; l < lanes; ++l) sum += acc[l];
+                return sum;
+            }
+
+            //! Folds every chunk of the range with op in parallel, returns the chunk bounds, the chunk sizes and the folded values of the first n_chunks - skip_last chunks
+            template<typename T, typename ForwardIt, typename BinaryOp>
+            void _fold_chunks(const parallel_policy &policy, ForwardIt first, ForwardIt last, BinaryOp &op, bool skip_last,
+                              std::vector<ForwardIt> &bounds, std::vector<std::size_t> &sizes, std::vector<T> &sums) {
+                n_subranges(first, last, std::back_inserter(bounds), policy.chunk_count());
+                const std::size_t n_chunks = bounds.size() - 1;
+                sizes.resize(n_chunks);
+
+                policy.parallel_for(n_chunks, [&](std::size_t k) {
+                    sizes[k] = static_cast<std::size_t>(std::distance(bounds[k], bounds[k + 1]));
+                    if (skip_last && k == n_chunks - 1) return;
+                    sums[k] = _fold_chunk<T>(bounds[k], bounds[k + 1], op, bool_constant<_is_vectorizable_sum<ForwardIt, T, BinaryOp>::value>());
+                });
+            }
+
+            //! Two-pass parallel scan, the chunks are folded first and then scanned starting from the combined value of all preceding chunks
+            template<typename T, typename ForwardIt, typename RandomIt, typename BinaryOp>
+            RandomIt _parallel_scan(const parallel_policy &policy, ForwardIt first, ForwardIt last, RandomIt dest, BinaryOp op,
+                                    const T *init, bool inclusive) {
+                if (first == last) return dest;
+
+                // The values are only placeholders for types without default constructor, they are overwritten before they are read
+                const T seed = (init != nullptr) ? *init : T(*first);
+                std::vector<ForwardIt> bounds;
+                std::vector<std::size_t> sizes;
+                std::vector<T> prefixes(std::min(policy.chunk_count(), static_cast<std::size_t>(std::distance(first, last))), seed);
+                _fold_chunks(policy, first, last, op, true, bounds, sizes, prefixes);
+                const std::size_t n_chunks = bounds.size() - 1;
+
+                // Turn the chunk sums into the exclusive prefixes of the chunks
+                std::vector<std::size_t> offsets(n_chunks, 0);
+                T running = seed;
+                for (std::size_t k = 0; k < n_chunks; ++k) {
+                    if (k > 0) offsets[k] = offsets[k - 1] + sizes[k - 1];
+                    T chunk_sum = std::move(prefixes[k]);
+                    prefixes[k] = running;
+                    if (k + 1 < n_chunks) running = (k == 0 && init == nullptr) ? std::move(chunk_sum) : op(running, chunk_sum);
+                }
+
+                policy.parallel_for(n_chunks, [&](std::size_t k) {
+                    auto current = bounds[k];
+                    auto out = dest + static_cast<typename std::iterator_traits<RandomIt>::difference_type>(offsets[k]);
+                    const bool has_prefix = (k > 0 || init != nullptr);
+
+                    if (inclusive) {
+                        T acc = has_prefix ? op(prefixes[k], *current) : T(*current);
+                        *out++ = acc;
+                        for (++current; current != bounds[k + 1]; ++current) {
+                            acc = op(std::move(acc), *current);
+                            *out++ = acc;
+                        }
+                    } else {
+                        T acc = prefixes[k];
+                        for (; current != bounds[k + 1]; ++current) {
+                            // Read the element before writing, the scan may be performed in-place
+                            T next = op(acc, *current);
+                            *out++ = std::move(acc);
+                            acc = std::move(next);
+                        }
+                    }
+                });
+
+                return dest + static_cast<typename std::iterator_traits<RandomIt>::difference_type>(offsets.back() + sizes.back());
+            }
+        }
+
+        //! Writes the inclusive prefix sums of the range combined with op, starting from init, to dest, the range is divided into chunks which are folded and then scanned in parallel
+        template<typename ForwardIt, typename RandomIt, typename BinaryOp, typename T>
+        RandomIt parallel_inclusive_scan(const parallel_policy &policy, ForwardIt first, ForwardIt last, RandomIt dest, BinaryOp op, T init) {
+            return _detail::_parallel_scan<T>(policy, first, last, dest, op, &init, true);
+        }
+
+        //! Writes the inclusive prefix sums of the range combined with op to dest, the range is divided into chunks which are folded and then scanned in parallel
+        template<typename ForwardIt, typename RandomIt, typename BinaryOp>
+        RandomIt parallel_inclusive_scan(const parallel_policy &policy, ForwardIt first, ForwardIt last, RandomIt dest, BinaryOp op) {
+            using value_t = typename std::iterator_traits<ForwardIt>::value_type;
+            return _detail::_parallel_scan<value_t>(policy, first, last, dest, op, static_cast<const value_t *>(nullptr), true);
+        }
+
+        //! Writes the inclusive prefix sums of the range to dest, the range is divided into chunks which are folded and then scanned in parallel
+        template<typename ForwardIt, typename RandomIt>
+        RandomIt parallel_inclusive_scan(const parallel_policy &policy, ForwardIt first, ForwardIt last, RandomIt dest) {
+            return parallel_inclusive_scan(policy, first, last, dest, std::plus<>());
+        }
+
+        //! Writes the exclusive prefix sums of the range combined with op, starting from init, to dest, the range is divided into chunks which are folded and then scanned in parallel
+        template<typename ForwardIt, typename RandomIt, typename T, typename BinaryOp>
+        RandomIt parallel_exclusive_scan(const parallel_policy &policy, ForwardIt first, ForwardIt last, RandomIt dest, T init, BinaryOp op) {
+            return _detail::_parallel_scan<T>(policy, first, last, dest, op, &init, false);
+        }
+
+        //! Writes the exclusive prefix sums of the range, starting from init, to dest, the range is divided into chunks which are folded and then scanned in parallel
+        template<typename ForwardIt, typename RandomIt, typename T>
+        RandomIt parallel_exclusive_scan(const parallel_policy &policy, ForwardIt first, ForwardIt last, RandomIt dest, T init) {
+            return parallel_exclusive_scan(policy, first, last, dest, init, std::plus<>());
+        }
+
+        //! Combines init and all elements of the range with the associative op, the chunks of the range are folded in parallel
+        template<typename ForwardIt, typename T, typename BinaryOp>
+        T parallel_reduce(const parallel_policy &policy, ForwardIt first, ForwardIt last, T init, BinaryOp op) {
+            if (first == last) return init;
+
+            std::vector<ForwardIt> bounds;
+            std::vector<std::size_t> sizes;
+            std::vector<T> sums(std::min(policy.chunk_count(), static_cast<std::size_t>(std::distance(first, last))), init);
+            _detail::_fold_chunks(policy, first, last, op, false, bounds, sizes, sums);
+
+            for (auto &sum : sums) init = op(std::move(init), sum);
+            return init;
+        }
+
+        //! Combines init and all elements of the range with operator+, the chunks of the range are folded in parallel
+        template<typename ForwardIt, typename T>
+        T parallel_reduce(const parallel_policy &policy, ForwardIt first, ForwardIt last, T init) {
+            return parallel_reduce(policy, first, last, init, std::plus<>());
+        }
+
+        //! Sums all elements of the range, the chunks of the range are folded in parallel
+        template<typename ForwardIt>
+        typename std::iterator_traits<ForwardIt>::value_type parallel_reduce(const parallel_policy &policy, ForwardIt first, ForwardIt last) {
+            return parallel_reduce(policy, first, last, typename std::iterator_traits<ForwardIt>::value_type{});
+        }
+
+        //! Summation used by the arithmetic overloads of deterministic_reduce
+        enum class summation_mode {
+            //! Plain sums combined along the fixed pairwise tree
+            pairwise,
+            //! Neumaier compensated sums within the leaves whose error terms are carried along the pairwise tree, equal to pairwise for non floating point types
+            compensated
+        };
+
+        namespace _detail {
+            //! Number of consecutive elements folded sequentially into one leaf of the pairwise tree of deterministic_reduce
+            NONAME_INLINE_VARIABLE constexpr std::size_t _deterministic_leaf_size = 128;
+
+            //! Sum with the accumulated rounding error of its additions
+            template<typename T>
+            struct _compensated_sum {
+                T sum;
+                T compensation;
+
+                //! Adds value and collects the rounding error of the addition (Neumaier's variant of Kahan summation)
+                void add(const T &value) {
+                    const T t = sum + value;
+                    if (std::abs(sum) >= std::abs(value)) compensation += (sum - t) + value;
+                    else compensation += (value - t) + sum;
+                    sum = t;
+                }
+
+                friend _compensated_sum operator+(_compensated_sum lhs, const _compensated_sum &rhs) {
+                    lhs.add(rhs.sum);
+                    lhs.compensation += rhs.compensation;
+                    return lhs;
+                }
+            };
+
+            //! Reduces the non-empty range along a pairwise tree over leaves of _deterministic_leaf_size elements, the shape of the tree only depends on the length of the range
+            /*
+             * The leaves are combined bottom-up, the node at index i of level l combines the leaves [i * 2^l, (i + 1) * 2^l),
+             * so aligned groups of leaves form complete subtrees which are reduced concurrently. The grouping only affects
+             * which thread computes a node, not the order of any operation, which makes the result bit-identical for every
+             * number of threads and chunks.
+             */
+            template<typename Node, typename RandomIt, typename LeafFunc, typename Combine, typename ForEachGroup>
+            Node _pairwise_tree_reduce(RandomIt first, RandomIt last, std::size_t n_groups_hint, LeafFunc leaf, Combine combine,
+                                       ForEachGroup for_each_group) {
+                const auto n = static_cast<std::size_t>(last - first);
+                const std::size_t n_leaves = (n + _deterministic_leaf_size - 1) / _deterministic_leaf_size;
+
+                // Largest power of two number of leaves per group which still gives every chunk a group
+                std::size_t group_size = 1;
+                while (group_size * 2 * std::max<std::size_t>(n_groups_hint, 1) <= n_leaves) group_size *= 2;
+                const std::size_t n_groups = (n_leaves + group_size - 1) / group_size;
+
+                const auto leaf_value = [&](std::size_t i) {
+                    const auto leaf_first = first + static_cast<std::ptrdiff_t>(i * _deterministic_leaf_size);
+                    const auto leaf_last = first + static_cast<std::ptrdiff_t>(std::min(n, (i + 1) * _deterministic_leaf_size));
+                    return leaf(leaf_first, leaf_last);
+                };
+
+                std::vector<Node> nodes(n_leaves, leaf_value(0));
+                for_each_group(n_groups, [&](std::size_t g) {
+                    const std::size_t group_first = g * group_size;
+                    const std::size_t group_last = std::min(n_leaves, group_first + group_size);
+                    for (std::size_t i = std::max<std::size_t>(group_first, 1); i < group_last; ++i) nodes[i] = leaf_value(i);
+                    for (std::size_t width = 1; width < group_size; width *= 2) {
+                        for (std::size_t i = group_first; i + width < group_last; i += 2 * width) nodes[i] = combine(nodes[i], nodes[i + width]);
+                    }
+                });
+
+                for (std::size_t width = group_size; width < n_leaves; width *= 2) {
+                    for (std::size_t i = 0; i + width < n_leaves; i += 2 * width) nodes[i] = combine(nodes[i], nodes[i + width]);
+                }
+                return nodes[0];
+            }
+
+            template<typename RandomIt, typename T, typename BinaryOp, typename ForEachGroup>
+            T _deterministic_reduce(RandomIt first, RandomIt last, T init, BinaryOp &op, std::size_t n_groups_hint, ForEachGroup for_each_group) {
+                if (first == last) return init;
+                // The fixed order of the leaf loop keeps the result deterministic, also for the loop with independent accumulators
+                const auto leaf = [&op](RandomIt leaf_first, RandomIt leaf_last) {
+                    return _fold_chunk<T>(leaf_first, leaf_last, op, bool_constant<_is_vectorizable_sum<RandomIt, T, BinaryOp>::value>());
+                };
+                const auto combine = [&op](const T &lhs, const T &rhs) { return op(lhs, rhs); };
+                return op(std::move(init), _pairwise_tree_reduce<T>(first, last, n_groups_hint, leaf, combine, for_each_group));
+            }
+
+            //! Plain pairwise sum, also used for the compensated mode of non floating point types whose additions do not round
+            template<typename RandomIt, typename T, typename ForEachGroup>
+            T _deterministic_sum(RandomIt first, RandomIt last, T init, std::size_t n_groups_hint, ForEachGroup for_each_group,
+                                 std::false_type /* compensated */) {
+                std::plus<> op;
+                return _deterministic_reduce(first, last, init, op, n_groups_hint, for_each_group);
+            }
+
+            template<typename RandomIt, typename T, typename ForEachGroup>
+            T _deterministic_sum(RandomIt first, RandomIt last, T init, std::size_t n_groups_hint, ForEachGroup for_each_group,
+                                 std::true_type /* compensated */) {
+                if (first == last) return init;
+                const auto leaf = [](RandomIt leaf_first, RandomIt leaf_last) {
+                    _compensated_sum<T> acc{T(), T()};
+                    for (; leaf_first != leaf_last; ++leaf_first) acc.add(*leaf_first);
+                    return acc;
+                };
+                const auto combine = [](const _compensated_sum<T> &lhs, const _compensated_sum<T> &rhs) { return lhs + rhs; };
+                const auto root = _compensated_sum<T>{init, T()} +
+                                  _pairwise_tree_reduce<_compensated_sum<T>>(first, last, n_groups_hint, leaf, combine, for_each_group);
+                return root.sum + root.compensation;
+            }
+
+            template<typename RandomIt, typename T, typename ForEachGroup>
+            T _deterministic_sum(RandomIt first, RandomIt last, T init, summation_mode mode, std::size_t n_groups_hint, ForEachGroup for_each_group) {
+                if (mode == summation_mode::compensated) {
+                    return _deterministic_sum(first, last, init, n_groups_hint, for_each_group, bool_constant<std::is_floating_point<T>::value>());
+                }
+                return _deterministic_sum(first, last, init, n_groups_hint, for_each_group, std::false_type());
+            }
+        }
+
+        //! Combines init and all elements of the range with the associative op along a fixed pairwise tree, the result does not depend on any partitioning of the range
+        template<typename RandomIt, typename T, typename BinaryOp>
+        T deterministic_reduce(RandomIt first, RandomIt last, T init, BinaryOp op) {
+            return _detail::_deterministic_reduce(first, last, init, op, 1, [](std::size_t n, auto &&f) {
+                for (std::size_t i = 0; i < n; ++i) f(i);
+            });
+        }
+
+        //! Combines init and all elements of the range with the associative op along a fixed pairwise tree, the subtrees are reduced in parallel and the result is bit-identical for every policy
+        template<typename RandomIt, typename T, typename BinaryOp>
+        T deterministic_reduce(const parallel_policy &policy, RandomIt first, RandomIt last, T init, BinaryOp op) {
+            return _detail::_deterministic_reduce(first, last, init, op, policy.chunk_count(), [&policy](std::size_t n, auto &&f) {
+                policy.parallel_for(n, f);
+            });
+        }
+
+        //! Sums init and all elements of the range along a fixed pairwise tree, optionally with compensated summation, the result does not depend on any partitioning of the range
+        template<typename RandomIt, typename T>
+        T deterministic_reduce(RandomIt first, RandomIt last, T init, summation_mode mode = summation_mode::pairwise) {
+            return _detail::_deterministic_sum(first, last, init, mode, 1, [](std::size_t n, auto &&f) {
+                for (std::size_t i = 0; i < n; ++i) f(i);
+            });
+        }
+
+        //! Sums init and all elements of the range along a fixed pairwise tree, optionally with compensated summation, the subtrees are summed in parallel and the result is bit-identical for every policy
+        template<typename RandomIt, typename T>
+        T deterministic_reduce(const parallel_policy &policy, RandomIt first, RandomIt last, T init, summation_mode mode = summation_mode::pairwise) {
+            return _detail::_deterministic_sum(first, last, init, mode, policy.chunk_count(), [&policy](std::size_t n, auto &&f) {
+                policy.parallel_for(n, f);
+            });
+        }
+
+        namespace _detail {
+            template<typename RandomIt1, typename RandomIt2, typename BucketFunc, typename ForEach>
+            std::vector<iterator_range<RandomIt2>> _multiway_partition(RandomIt1 first, RandomIt1 last, RandomIt2 dest, BucketFunc &bucket,
+                                                                       std::size_t k, std::size_t n_chunks, ForEach for_each) {
+                const auto n = static_cast<std::size_t>(last - first);
+                n_chunks = std::max<std::size_t>(std::min(n_chunks, n), 1);
+                const auto chunk_first = [n, n_chunks](std::size_t c) { return n * c / n_chunks; };
+
+                // Histogram of the buckets per chunk
+                std::vector<std::uint32_t> buckets(n);
+                std::vector<std::size_t> offsets(n_chunks * k, 0);
+                for_each(n_chunks, [&](std::size_t c) {
+                    for (std::size_t i = chunk_first(c); i < chunk_first(c + 1); ++i) {
+                        buckets[i] = static_cast<std::uint32_t>(bucket(first[i]));
+                        offsets[c * k + buckets[i]]++;
+                    }
+                });
+
+                // Bucket-major prefix sum keeps the elements of every bucket in input order
+                std::vector<std::size_t> bucket_bounds(k + 1, 0);
+                std::size_t running = 0;
+                for (std::size_t b = 0; b < k; ++b) {
+                    bucket_bounds[b] = running;
+                    for (std::size_t c = 0; c < n_chunks; ++c) {
+                        const std::size_t count = offsets[c * k + b];
+                        offsets[c * k + b] = running;
+                        running += count;
+                    }
+                }
+                bucket_bounds[k] = running;
+
+                for_each(n_chunks, [&](std::size_t c) {
+                    std::size_t *chunk_offsets = &offsets[c * k];
+                    for (std::size_t i = chunk_first(c); i < chunk_first(c + 1); ++i) dest[chunk_offsets[buckets[i]]++] = first[i];
+                });
+
+                std::vector<iterator_range<RandomIt2>> ranges;
+                ranges.reserve(k);
+                for (std::size_t b = 0; b < k; ++b) {
+                    ranges.emplace_back(dest + static_cast<std::ptrdiff_t>(bucket_bounds[b]), dest + static_cast<std::ptrdiff_t>(bucket_bounds[b + 1]));
+                }
+                return ranges;
+            }
+        }
+
+        //! Copies the elements of the range to dest grouped by their bucket(element) in [0, k) and returns the k bucket ranges in dest, the elements of every bucket keep their order
+        template<typename RandomIt1, typename RandomIt2, typename BucketFunc>
+        std::vector<iterator_range<RandomIt2>> multiway_partition(RandomIt1 first, RandomIt1 last, RandomIt2 dest, BucketFunc bucket, std::size_t k) {
+            return _detail::_multiway_partition(first, last, dest, bucket, k, 1, [](std::size_t n, auto &&f) {
+                for (std::size_t i = 0; i < n; ++i) f(i);
+            });
+        }
+
+        //! Copies the elements of the range to dest grouped by their bucket(element) in [0, k) and returns the k bucket ranges in dest, the chunks are counted and scattered in parallel
+        template<typename RandomIt1, typename RandomIt2, typename BucketFunc>
+        std::vector<iterator_range<RandomIt2>> multiway_partition(const parallel_policy &policy, RandomIt1 first, RandomIt1 last, RandomIt2 dest,
+                                                                  BucketFunc bucket, std::size_t k) {
+            return _detail::_multiway_partition(first, last, dest, bucket, k, policy.chunk_count(), [&policy](std::size_t n, auto &&f) {
+                policy.parallel_for(n, f);
+            });
+        }
+
+        namespace _detail {
+            template<typename RandomIt, typename KeyFunc>
+            using _key_t = std::decay_t<decltype(std::declval<KeyFunc &>()(*std::declval<RandomIt>()))>;
+
+            template<typename RandomIt, typename KeyFunc>
+            using _key_count_vector = std::vector<std::pair<_key_t<RandomIt, KeyFunc>, std::size_t>>;
+
+            //! Number of occurrences of a key, the key is represented by the index of an element with that key
+            struct _key_count {
+                std::uint64_t hash;
+                std::size_t index;
+                std::size_t count;
+            };
+
+            //! Open addressing table counting keys by their hash and the index of an element with that key
+            /*
+             * Scalar linear probing: every probe compares a single slot and stops at the first empty or matching slot.
+             */
+            class _count_table {
+            public:
+                //! Adds count occurrences of the key of element index, equal(i, j) compares the keys of the elements i and j
+                template<typename Equal>
+                void add(std::uint64_t hash, std::size_t index, std::size_t count, Equal &equal) {
+                    if (2 * (m_size + 1) > m_slots.size()) grow();
+                    const std::size_t mask = m_slots.size() - 1;
+                    std::size_t slot = static_cast<std::size_t>(hash) & mask;
+                    while (true) {
+                        auto &entry = m_slots[slot];
+                        if (entry.count == 0) {
+                            entry = {hash, index, count};
+                            ++m_size;
+                            return;
+                        }
+                        if (entry.hash == hash && equal(entry.index, index)) {
+                            entry.count += count;
+                            return;
+                        }
+                        slot = (slot + 1) & mask;
+                    }
+                }
+
+                //! Calls f for every counted key
+                template<typename Func>
+                void for_each_entry(Func f) const {
+                    for (const auto &entry : m_slots) {
+                        if (entry.count != 0) f(entry);
+                    }
+                }
+
+                std::size_t size() const {
+                    return m_size;
+                }
+
+            private:
+                void grow() {
+                    std::vector<_key_count> slots(std::max<std::size_t>(16, 2 * m_slots.size()), _key_count{0, 0, 0});
+                    const std::size_t mask = slots.size() - 1;
+                    for (const auto &entry : m_slots) {
+                        if (entry.count == 0) continue;
+                        std::size_t slot = static_cast<std::size_t>(entry.hash) & mask;
+                        while (slots[slot].count != 0) slot = (slot + 1) & mask;
+                        slots[slot] = entry;
+                    }
+                    m_slots = std::move(slots);
+                }
+
+                //! Slots with a zero count are empty
+                std::vector<_key_count> m_slots;
+                std::size_t m_size = 0;
+            };
+
+            //! Counts the keys in one table per chunk and hash partition, the tables of every partition are then merged in parallel
+            template<typename RandomIt, typename KeyFunc, typename ForEach>
+            _key_count_vector<RandomIt, KeyFunc> _count_by_key(RandomIt first, RandomIt last, KeyFunc &key, std::size_t n_chunks, ForEach for_each,
+                                                               std::false_type /* integral key */) {
+                using key_t = _key_t<RandomIt, KeyFunc>;
+                const auto n = static_cast<std::size_t>(last - first);
+                n_chunks = std::max<std::size_t>(std::min(n_chunks, n), 1);
+                const auto chunk_first = [n, n_chunks](std::size_t c) { return n * c / n_chunks; };
+
+                // Several partitions per chunk balance the merge step if the keys are not spread evenly
+                unsigned partition_bits = 0;
+                while (n_chunks > 1 && (std::size_t(1) << partition_bits) < 4 * n_chunks) ++partition_bits;
+                const std::size_t n_partitions = std::size_t(1) << partition_bits;
+                const auto partition = [partition_bits](std::uint64_t h) {
+                    return (partition_bits == 0) ? std::size_t(0) : static_cast<std::size_t>(h >> (64 - partition_bits));
+                };
+
+                std::hash<key_t> hash;
+                const auto equal = [&](std::size_t i, std::size_t j) { return key(first[i]) == key(first[j]); };
+                std::vector<_count_table> tables(n_chunks * n_partitions);
+                for_each(n_chunks, [&](std::size_t c) {
+                    for (std::size_t i = chunk_first(c); i < chunk_first(c + 1); ++i) {
+                        const auto h = _mix_hash(static_cast<std::uint64_t>(hash(key(first[i]))));
+                        tables[c * n_partitions + partition(h)].add(h, i, 1, equal);
+                    }
+                });
+
+                // The tables of the first chunk collect the counts of all chunks
+                for_each(n_partitions, [&](std::size_t p) {
+                    for (std::size_t c = 1; c < n_chunks; ++c) {
+                        auto &table = tables[c * n_partitions + p];
+                        table.for_each_entry([&](const _key_count &e) { tables[p].add(e.hash, e.index, e.count, equal); });
+                        table = _count_table();
+                    }
+                });
+
+                std::size_t n_keys = 0;
+                for (std::size_t p = 0; p < n_partitions; ++p) n_keys += tables[p].size();
+                _key_count_vector<RandomIt, KeyFunc> result;
+                result.reserve(n_keys);
+                for (std::size_t p = 0; p < n_partitions; ++p) {
+                    tables[p].for_each_entry([&](const _key_count &e) { result.emplace_back(key(first[e.index]), e.count); });
+                }
+                return result;
+            }
+
+            //! Counts small integral keys in one dense array of counters per chunk, falls back to the hash tables if the keys span a too large interval
+            template<typename RandomIt, typename KeyFunc, typename ForEach>
+            _key_count_vector<RandomIt, KeyFunc> _count_by_key(RandomIt first, RandomIt last, KeyFunc &key, std::size_t n_chunks, ForEach for_each,
+                                                               std::true_type /* integral key */) {
+                using key_t = _key_t<RandomIt, KeyFunc>;
+                const auto n = static_cast<std::size_t>(last - first);
+                if (n == 0) return {};
+                n_chunks = std::max<std::size_t>(std::min(n_chunks, n), 1);
+                const auto chunk_first = [n, n_chunks](std::size_t c) { return n * c / n_chunks; };
+
+                std::vector<key_t> min_keys(n_chunks), max_keys(n_chunks);
+                for_each(n_chunks, [&](std::size_t c) {
+                    key_t lo = key(first[chunk_first(c)]);
+                    key_t hi = lo;
+                    for (std::size_t i = chunk_first(c) + 1; i < chunk_first(c + 1); ++i) {
+                        const key_t k = key(first[i]);
+                        if (k < lo) lo = k;
+                        if (hi < k) hi = k;
+                    }
+                    min_keys[c] = lo;
+                    max_keys[c] = hi;
+                });
+                const auto lo = static_cast<std::uint64_t>(*std::min_element(min_keys.begin(), min_keys.end()));
+                const auto span = static_cast<std::uint64_t>(*std::max_element(max_keys.begin(), max_keys.end())) - lo;
+
+                // The counters of all chunks together may not take more memory than the range itself
+                constexpr std::size_t min_dense_size = 1 << 12;
+                constexpr std::size_t max_dense_size = 1 << 24;
+                if (span >= std::min(std::max(min_dense_size, n / n_chunks), max_dense_size)) {
+                    return _count_by_key(first, last, key, n_chunks, for_each, std::false_type());
+                }
+
+                const auto m = static_cast<std::size_t>(span) + 1;
+                std::vector<std::size_t> counts(n_chunks * m, 0);
+                for_each(n_chunks, [&](std::size_t c) {
+                    std::size_t *chunk_counts = &counts[c * m];
+                    for (std::size_t i = chunk_first(c); i < chunk_first(c + 1); ++i) {
+                        chunk_counts[static_cast<std::size_t>(static_cast<std::uint64_t>(key(first[i])) - lo)]++;
+                    }
+                });
+                for_each(n_chunks, [&](std::size_t s) {
+                    for (std::size_t j = m * s / n_chunks; j < m * (s + 1) / n_chunks; ++j) {
+                        for (std::size_t c = 1; c < n_chunks; ++c) counts[j] += counts[c * m + j];
+                    }
+                });
+
+                _key_count_vector<RandomIt, KeyFunc> result;
+                for (std::size_t j = 0; j < m; ++j) {
+                    if (counts[j] != 0) result.emplace_back(static_cast<key_t>(lo + j), counts[j]);
+                }
+                return result;
+            }
+
+            //! Sorts the key counts by their keys unless they are already sorted
+            template<typename KeyCountVector, typename Sort>
+            KeyCountVector _sort_key_counts(KeyCountVector counts, Sort sort) {
+                const auto key_less = [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; };
+                if (!std::is_sorted(counts.begin(), counts.end(), key_less)) sort(counts.begin(), counts.end(), key_less);
+                return counts;
+            }
+        }
+
+        //! Counts the occurrences of every distinct key(element) of the range and returns the keys with their counts in unspecified order, small integral keys are counted in a dense array instead of a hash table
+        template<typename RandomIt, typename KeyFunc>
+        _detail::_key_count_vector<RandomIt, KeyFunc> count_by_key(RandomIt first, RandomIt last, KeyFunc key) {
+            return _detail::_count_by_key(first, last, key, 1, [](std::size_t n, auto &&f) {
+                for (std::size_t i = 0; i < n; ++i) f(i);
+            }, std::is_integral<_detail::_key_t<RandomIt, KeyFunc>>());
+        }
+
+        //! Counts the occurrences of every distinct element of the range and returns the elements with their counts in unspecified order, small integral keys are counted in a dense array instead of a hash table
+        template<typename RandomIt>
+        _detail::_key_count_vector<RandomIt, _detail::_identity_key> count_by_key(RandomIt first, RandomIt last) {
+            return count_by_key(first, last, _detail::_identity_key());
+        }
+
+        //! Counts the occurrences of every distinct key(element) of the range and returns the keys with their counts in unspecified order, every chunk counts in its own hash tables which are merged per partition of the hash values in parallel
+        template<typename RandomIt, typename KeyFunc>
+        _detail::_key_count_vector<RandomIt, KeyFunc> count_by_key(const parallel_policy &policy, RandomIt first, RandomIt last, KeyFunc key) {
+            return _detail::_count_by_key(first, last, key, policy.chunk_count(), [&policy](std::size_t n, auto &&f) {
+                policy.parallel_for(n, f);
+            }, std::is_integral<_detail::_key_t<RandomIt, KeyFunc>>());
+        }
+
+        //! Counts the occurrences of every distinct element of the range and returns the elements with their counts in unspecified order, every chunk counts in its own hash tables which are merged per partition of the hash values in parallel
+        template<typename RandomIt>
+        _detail::_key_count_vector<RandomIt, _detail::_identity_key> count_by_key(const parallel_policy &policy, RandomIt first, RandomIt last) {
+            return count_by_key(policy, first, last, _detail::_identity_key());
+        }
+
+        //! Counts the occurrences of every distinct key(element) of the range like count_by_key and returns the keys with their counts sorted by key
+        template<typename RandomIt, typename KeyFunc>
+        _detail::_key_count_vector<RandomIt, KeyFunc> count_by_key_sorted(RandomIt first, RandomIt last, KeyFunc key) {
+            return _detail::_sort_key_counts(count_by_key(first, last, key), [](auto first, auto last, auto comp) {
+                std::sort(first, last, comp);
+            });
+        }
+
+        //! Counts the occurrences of every distinct element of the range like count_by_key and returns the elements with their counts sorted by element
+        template<typename RandomIt>
+        _detail::_key_count_vector<RandomIt, _detail::_identity_key> count_by_key_sorted(RandomIt first, RandomIt last) {
+            return count_by_key_sorted(first, last, _detail::_identity_key());
+        }
+
+        //! Counts the occurrences of every distinct key(element) of the range in parallel like count_by_key and returns the keys with their counts sorted by key
+        template<typename RandomIt, typename KeyFunc>
+        _detail::_key_count_vector<RandomIt, KeyFunc> count_by_key_sorted(const parallel_policy &policy, RandomIt first, RandomIt last, KeyFunc key) {
+            return _detail::_sort_key_counts(count_by_key(policy, first, last, key), [&policy](auto first, auto last, auto comp) {
+                parallel_sort(policy, first, last, comp);
+            });
+        }
+
+        //! Counts the occurrences of every distinct element of the range in parallel like count_by_key and returns the elements with their counts sorted by element
+        template<typename RandomIt>
+        _detail::_key_count_vector<RandomIt, _detail::_identity_key> count_by_key_sorted(const parallel_policy &policy, RandomIt first, RandomIt last) {
+            return count_by_key_sorted(policy, first, last, _detail::_identity_key());
+        }
+
+        namespace _detail {
+            //! Calls f(run1_first, run1_last, run2_first, run2_last) for every pair of runs of equal keys in the sorted ranges 1 and 2
+            template<typename ForwardIt1, typename ForwardIt2, typename KeyFunc1, typename KeyFunc2, typename Func>
+            void _for_each_join_run(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, ForwardIt2 last2, KeyFunc1 &key1, KeyFunc2 &key2, Func &&f) {
+                while (first1 != last1 && first2 != last2) {
+                    if (key1(*first1) < key2(*first2)) {
+                        ++first1;
+                    } else if (key2(*first2) < key1(*first1)) {
+                        ++first2;
+                    } else {
+                        auto run1_last = std::next(first1);
+                        while (run1_last != last1 && !(key1(*first1) < key1(*run1_last))) ++run1_last;
+                        auto run2_last = std::next(first2);
+                        while (run2_last != last2 && !(key2(*first2) < key2(*run2_last))) ++run2_last;
+                        f(first1, run1_last, first2, run2_last);
+                        first1 = run1_last;
+                        first2 = run2_last;
+                    }
+                }
+            }
+
+            //! Divides the sorted ranges 1 and 2 into n_chunks pairs of subranges of nearly equal total size along their merge path, all elements with equal keys end up in the same chunk
+            template<typename RandomIt1, typename RandomIt2, typename KeyFunc1, typename KeyFunc2>
+            std::vector<std::pair<std::size_t, std::size_t>> _merge_join_bounds(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2,
+                                                                                KeyFunc1 &key1, KeyFunc2 &key2, std::size_t n_chunks) {
+                const auto n1 = static_cast<std::size_t>(last1 - first1);
+                const auto n2 = static_cast<std::size_t>(last2 - first2);
+                n_chunks = std::max<std::size_t>(std::min(n_chunks, n1 + n2), 1);
+                auto comp = [&](const auto &b, const auto &a) { return key2(b) < key1(a); };
+
+                // A boundary inside a run of equal keys is moved to the first element of that key in both ranges
+                const auto snap = [&](const auto &key, std::size_t i, std::size_t j) {
+                    const auto i_first = std::partition_point(first1, first1 + i, [&](const auto &a) { return key1(a) < key; }) - first1;
+                    const auto j_first = std::partition_point(first2, first2 + j, [&](const auto &b) { return key2(b) < key; }) - first2;
+                    return std::make_pair(static_cast<std::size_t>(i_first), static_cast<std::size_t>(j_first));
+                };
+
+                std::vector<std::pair<std::size_t, std::size_t>> bounds(n_chunks + 1, std::make_pair(n1, n2));
+                bounds[0] = std::make_pair(std::size_t(0), std::size_t(0));
+                for (std::size_t c = 1; c < n_chunks; ++c) {
+                    const std::size_t diag = (n1 + n2) * c / n_chunks;
+                    const std::size_t i = _merge_path_split(first1, n1, first2, n2, diag, comp);
+                    const std::size_t j = diag - i;
+                    if (i < n1 && (j == n2 || !(key2(first2[j]) < key1(first1[i])))) {
+                        bounds[c] = snap(key1(first1[i]), i, std::min(j + 1, n2));
+                    } else if (j < n2) {
+                        bounds[c] = snap(key2(first2[j]), i, j + 1);
+                    }
+                }
+                return bounds;
+            }
+        }
+
+        //! Calls f(a, b) for every pair of elements a of the sorted range 1 and b of the sorted range 2 with key1(a) == key2(b), pairs with equal keys are visited in the order of both ranges, returns copy/move of functor
+        template<typename ForwardIt1, typename ForwardIt2, typename KeyFunc1, typename KeyFunc2, typename Func>
+        Func merge_join(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, ForwardIt2 last2, KeyFunc1 key1, KeyFunc2 key2, Func f) {
+            _detail::_for_each_join_run(first1, last1, first2, last2, key1, key2, [&f](auto run1_first, auto run1_last, auto run2_first, auto run2_last) {
+                for (auto a = run1_first; a != run1_last; ++a) {
+                    for (auto b = run2_first; b != run2_last; ++b) f(*a, *b);
+                }
+            });
+            return f;
+        }
+
+        //! Calls f(a, b) for every pair of equal elements a of the sorted range 1 and b of the sorted range 2, returns copy/move of functor
+        template<typename ForwardIt1, typename ForwardIt2, typename Func>
+        Func merge_join(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, ForwardIt2 last2, Func f) {
+            return merge_join(first1, last1, first2, last2, _detail::_identity_key(), _detail::_identity_key(), std::move(f));
+        }
+
+        //! Calls copies of f(a, b) for every pair of elements a of the sorted range 1 and b of the sorted range 2 with key1(a) == key2(b) in parallel, both ranges are divided along their merge path at key boundaries and every chunk uses its own copy of f which is discarded afterwards, so nothing is returned
+        template<typename RandomIt1, typename RandomIt2, typename KeyFunc1, typename KeyFunc2, typename Func>
+        void merge_join(const parallel_policy &policy, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, KeyFunc1 key1, KeyFunc2 key2, Func f) {
+            const auto bounds = _detail::_merge_join_bounds(first1, last1, first2, last2, key1, key2, policy.chunk_count());
+            policy.parallel_for(bounds.size() - 1, [&](std::size_t c) {
+                merge_join(first1 + bounds[c].first, first1 + bounds[c + 1].first, first2 + bounds[c].second, first2 + bounds[c + 1].second, key1, key2, f);
+            });
+        }
+
+        //! Calls copies of f(a, b) for every pair of equal elements a of the sorted range 1 and b of the sorted range 2 in parallel, every chunk uses its own copy of f which is discarded afterwards, so nothing is returned
+        template<typename RandomIt1, typename RandomIt2, typename Func>
+        void merge_join(const parallel_policy &policy, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, Func f) {
+            merge_join(policy, first1, last1, first2, last2, _detail::_identity_key(), _detail::_identity_key(), std::move(f));
+        }
+
+        //! Writes std::pair(a, b) to dest for every pair of elements a of the sorted range 1 and b of the sorted range 2 with key1(a) == key2(b) in the order of merge_join
+        template<typename ForwardIt1, typename ForwardIt2, typename KeyFunc1, typename KeyFunc2, typename OutputIt>
+        OutputIt merge_join_copy(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, ForwardIt2 last2, KeyFunc1 key1, KeyFunc2 key2, OutputIt dest) {
+            merge_join(first1, last1, first2, last2, std::move(key1), std::move(key2), [&dest](const auto &a, const auto &b) {
+                *dest++ = std::make_pair(a, b);
+            });
+            return dest;
+        }
+
+        //! Writes std::pair(a, b) to dest for every pair of equal elements a of the sorted range 1 and b of the sorted range 2 in the order of merge_join
+        template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+        OutputIt merge_join_copy(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, ForwardIt2 last2, OutputIt dest) {
+            return merge_join_copy(first1, last1, first2, last2, _detail::_identity_key(), _detail::_identity_key(), dest);
+        }
+
+        //! Writes std::pair(a, b) to dest for every pair of elements a of the sorted range 1 and b of the sorted range 2 with key1(a) == key2(b) in parallel, the output is identical to the serial merge_join_copy
+        /*
+         * Every chunk counts its output pairs first, so the chunks can write to their own parts of dest concurrently.
+         */
+        template<typename RandomIt1, typename RandomIt2, typename KeyFunc1, typename KeyFunc2, typename RandomIt3>
+        RandomIt3 merge_join_copy(const parallel_policy &policy, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2,
+                                  KeyFunc1 key1, KeyFunc2 key2, RandomIt3 dest) {
+            const auto bounds = _detail::_merge_join_bounds(first1, last1, first2, last2, key1, key2, policy.chunk_count());
+            const std::size_t n_chunks = bounds.size() - 1;
+
+            std::vector<std::size_t> offsets(n_chunks + 1, 0);
+            policy.parallel_for(n_chunks, [&](std::size_t c) {
+                _detail::_for_each_join_run(first1 + bounds[c].first, first1 + bounds[c + 1].first, first2 + bounds[c].second, first2 + bounds[c + 1].second,
+                                            key1, key2, [&](auto run1_first, auto run1_last, auto run2_first, auto run2_last) {
+                            offsets[c + 1] += static_cast<std::size_t>(run1_last - run1_first) * static_cast<std::size_t>(run2_last - run2_first);
+                        });
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            policy.parallel_for(n_chunks, [&](std::size_t c) {
+                merge_join_copy(first1 + bounds[c].first, first1 + bounds[c + 1].first, first2 + bounds[c].second, first2 + bounds[c + 1].second,
+                                key1, key2, dest + static_cast<std::ptrdiff_t>(offsets[c]));
+            });
+            return dest + static_cast<std::ptrdiff_t>(offsets[n_chunks]);
+        }
+
+        //! Writes std::pair(a, b) to dest for every pair of equal elements a of the sorted range 1 and b of the sorted range 2 in parallel, the output is identical to the serial merge_join_copy
+        template<typename RandomIt1, typename RandomIt2, typename RandomIt3>
+        RandomIt3 merge_join_copy(const parallel_policy &policy, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, RandomIt3 dest) {
+            return merge_join_copy(policy, first1, last1, first2, last2, _detail::_identity_key(), _detail::_identity_key(), dest);
+        }
+
+        namespace _detail {
+            //! Output iterator adapter which collects up to N values in inline storage and forwards them as an iterator_range to a callable
+            template<typename T, std::size_t N, typename Func>
+            class _buffered_output_iterator_adapter {
+            public:
+                using value_type = void;
+                using difference_type = void;
+                using pointer = void;
+                using reference = void;
+                using iterator_category = std::output_iterator_tag;
+
+                explicit _buffered_output_iterator_adapter(Func callable)
+                        : f{std::move(callable)} {}
+
+                //! Flushes the values buffered by other, so that every value is only forwarded by one of the copies
+                _buffered_output_iterator_adapter(const _buffered_output_iterator_adapter &other)
+                        : f{other.f.callable} {
+                    other.flush();
+                }
+
+                //! Takes over the values buffered by other
+                _buffered_output_iterator_adapter(_buffered_output_iterator_adapter &&other)
+                        : f{std::move(other.f.callable)} {
+                    take(other);
+                }
+
+                _buffered_output_iterator_adapter &operator=(const _buffered_output_iterator_adapter &other) {
+                    if (this != &other) {
+                        flush();
+                        other.flush();
+                        f = other.f;
+                    }
+                    return *this;
+                }
+
+                _buffered_output_iterator_adapter &operator=(_buffered_output_iterator_adapter &&other) {
+                    if (this != &other) {
+                        flush();
+                        // callable_container only supports copy assignment, so the callable is move constructed in place
+                        f.callable.~Func();
+                        ::new(static_cast<void *>(&f.callable)) Func(std::move(other.f.callable));
+                        take(other);
+                    }
+                    return *this;
+                }
+
+                //! Forwards the remaining values, an exception thrown by the callable is swallowed and the remaining values are dropped
+                ~_buffered_output_iterator_adapter() {
+                    try {
+                        flush();
+                    } catch (...) {
+                        discard();
+                    }
+                }
+
+                //! Appends the value to the buffer, forwards the buffer to the callable if it is full
+                _buffered_output_iterator_adapter &operator=(const T &value) {
+                    ::new(static_cast<void *>(data() + count)) T(value);
+                    if (++count == N) flush();
+                    return *this;
+                }
+
+                //! Appends the value to the buffer, forwards the buffer to the callable if it is full
+                _buffered_output_iterator_adapter &operator=(T &&value) {
+                    ::new(static_cast<void *>(data() + count)) T(std::move(value));
+                    if (++count == N) flush();
+                    return *this;
+                }
+
+                //! No-op, function is provided to satisfy the requirements of OutputIterator
+                _buffered_output_iterator_adapter &operator*() { return *this; }
+
+                //! No-op, function is provided to satisfy the requirements of OutputIterator
+                _buffered_output_iterator_adapter &operator++() { return *this; }
+
+                //! No-op, function is provided to satisfy the requirements of OutputIterator
+                _buffered_output_iterator_adapter &operator++(int) { return *this; }
+
+                //! Forwards all buffered values to the callable and empties the buffer, the values stay buffered if the callable throws
+                void flush() const {
+                    if (count == 0) return;
+                    f.callable(iterator_range<T *>(data(), data() + count));
+                    for (std::size_t i = 0; i < count; ++i) data()[i].~T();
+                    count = 0;
+                }
+
+            private:
+                T *data() const { return reinterpret_cast<T *>(&buffer[0]); }
+
+                void discard() const {
+                    for (std::size_t i = 0; i < count; ++i) data()[i].~T();
+                    count = 0;
+                }
+
+                void take(_buffered_output_iterator_adapter &other) {
+                    for (std::size_t i = 0; i < other.count; ++i) {
+                        ::new(static_cast<void *>(data() + i)) T(std::move(other.data()[i]));
+                        other.data()[i].~T();
+                    }
+                    count = other.count;
+                    other.count = 0;
+                }
+
+                // Flushing is allowed on const copies because all buffered values have been assigned through the adapter before
+                mutable callable_container<Func> f;
+                mutable typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer[N];
+                mutable std::size_t count = 0;
+            };
+        }
+
+        //! Returns an OutputIterator like type which collects up to N assigned values of type T in inline storage and forwards them as an iterator_range<T*> to the supplied callable
+        /*
+        * The buffer is forwarded when it is full, when flush() is called and on destruction. Copying the adapter forwards the
+        * values buffered by the source first, moving it takes over the buffered values. The destructor cannot report an
+        * exception of the callable, it drops the remaining values instead, so callers with a throwing callable have to call
+        * flush() before the adapter is destroyed.
+        */
+        template<typename T, std::size_t N, typename Func>
+        auto make_buffered_output_iterator_adapter(Func f) {
+            static_assert(N > 0, "The buffer has to hold at least one value.");
+            return _detail::_buffered_output_iterator_adapter<T, N, typename std::decay<Func>::type>(std::move(f));
+        }
+
+        namespace _detail {
+            //! Adds the value to the heap of the first k values in the order of comp, the front of the heap is the last of these values
+            template<typename T, typename V, typename Compare>
+            void _push_bounded_heap(std::vector<T> &heap, std::size_t k, V &&value, Compare &comp) {
+                if (heap.size() < k) {
+                    heap.push_back(std::forward<V>(value));
+                    std::push_heap(heap.begin(), heap.end(), comp);
+                } else if (k != 0 && comp(value, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), comp);
+                    heap.back() = std::forward<V>(value);
+                    std::push_heap(heap.begin(), heap.end(), comp);
+                }
+            }
+        }
+
+        //! Keeps the first k of all values pushed to it in the order of comp (e.g. the k smallest values for std::less) in a bounded heap
+        /*
+         * Every pushed value is only compared to the front of the heap unless it belongs to the first k values seen so far.
+         */
+        template<typename T, typename Compare = std::less<>>
+        class top_k_accumulator {
+        public:
+            explicit top_k_accumulator(std::size_t k, Compare comp = Compare())
+                    : m_k(k), m_comp(std::move(comp)) {}
+
+            //! Adds a value to the accumulator
+            void push(const T &value) {
+                _detail::_push_bounded_heap(m_heap, m_k, value, m_comp);
+            }
+
+            //! Adds a value to the accumulator
+            void push(T &&value) {
+                _detail::_push_bounded_heap(m_heap, m_k, std::move(value), m_comp);
+            }
+
+            //! Adds all values kept by other, e.g. to combine the accumulators of several threads
+            void merge(const top_k_accumulator &other) {
+                // Merging an accumulator into itself keeps its values
+                if (&other == this) return;
+                for (const auto &value : other.m_heap) push(value);
+            }
+
+            //! Returns an OutputIterator like type which pushes all values assigned to it to this accumulator
+            auto output_iterator() {
+                return make_output_iterator_adapter([this](const T &value) { push(value); });
+            }
+
+            //! Returns the kept values sorted by comp
+            std::vector<T> sorted_values() const {
+                auto values = m_heap;
+                std::sort_heap(values.begin(), values.end(), m_comp);
+                return values;
+            }
+
+            //! Returns the number of kept values, at most k
+            std::size_t size() const {
+                return m_heap.size();
+            }
+
+            //! Returns the maximum number of kept values
+            std::size_t k() const {
+                return m_k;
+            }
+
+            //! Removes all kept values
+            void clear() {
+                m_heap.clear();
+            }
+
+        private:
+            std::size_t m_k;
+            Compare m_comp;
+            std::vector<T> m_heap;
+        };
+
+        //! Returns the first k elements of the range sorted by comp like std::partial_sort, every chunk selects its candidates concurrently before they are merged
+        /*
+         * Chunks that are much larger than k keep their candidates in a bounded heap without copying the chunk,
+         * otherwise the chunk is copied and its candidates are selected by std::nth_element.
+         */
+        template<typename RandomIt, typename Compare = std::less<>>
+        std::vector<typename std::iterator_traits<RandomIt>::value_type> parallel_top_k(const parallel_policy &policy, RandomIt first, RandomIt last,
+                                                                                        std::size_t k, Compare comp = Compare()) {
+            using value_t = typename std::iterator_traits<RandomIt>::value_type;
+            const auto n = static_cast<std::size_t>(last - first);
+            k = std::min(k, n);
+            if (k == 0) return {};
+            const std::size_t n_chunks = std::max<std::size_t>(std::min(policy.chunk_count(), n), 1);
+            const auto chunk_first = [n, n_chunks](std::size_t c) { return static_cast<std::ptrdiff_t>(n * c / n_chunks); };
+
+            std::vector<std::vector<value_t>> candidates(n_chunks);
+            policy.parallel_for(n_chunks, [&](std::size_t c) {
+                const auto chunk_begin = first + chunk_first(c);
+                const auto chunk_end = first + chunk_first(c + 1);
+                const auto m = static_cast<std::size_t>(chunk_end - chunk_begin);
+                auto &chunk_candidates = candidates[c];
+                if (m > 8 * k) {
+                    for (auto it = chunk_begin; it != chunk_end; ++it) _detail::_push_bounded_heap(chunk_candidates, k, *it, comp);
+                } else {
+                    chunk_candidates.assign(chunk_begin, chunk_end);
+                    if (m > k) {
+                        std::nth_element(chunk_candidates.begin(), chunk_candidates.begin() + k, chunk_candidates.end(), comp);
+                        chunk_candidates.erase(chunk_candidates.begin() + k, chunk_candidates.end());
+                    }
+                }
+            });
+
+            std::vector<value_t> result = std::move(candidates[0]);
+            for (std::size_t c = 1; c < n_chunks; ++c) {
+                result.insert(result.end(), std::make_move_iterator(candidates[c].begin()), std::make_move_iterator(candidates[c].end()));
+            }
+            std::partial_sort(result.begin(), result.begin() + k, result.end(), comp);
+            result.erase(result.begin() + k, result.end());
+            return result;
+        }
+
+        //! Returns the first k elements of the range sorted by comp like std::partial_sort, the candidates are selected in parallel using the default parallel policy
+        template<typename RandomIt, typename Compare = std::less<>>
+        std::vector<typename std::iterator_traits<RandomIt>::value_type> parallel_top_k(RandomIt first, RandomIt last, std::size_t k, Compare comp = Compare()) {
+            return parallel_top_k(par, first, last, k, std::move(comp));
         }
     }
 }
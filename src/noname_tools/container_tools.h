@@ -0,0 +1,1195 @@
+#pragma once
+
+//	MIT License
+//
+//	Copyright (c) 2020 Fabian Löschner
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include <vector>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <initializer_list>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <atomic>
+#include <array>
+
+#include "general_defs.h"
+#include "functional_tools.h"
+#include "typetraits_tools.h"
+
+namespace noname {
+    namespace tools {
+        namespace _detail {
+            //! Returns the first member of a pair as its key, used by flat_map
+            struct _first_key {
+                template<typename T>
+                const typename T::first_type &operator()(const T &value) const { return value.first; }
+            };
+
+            //! Enables the heterogeneous lookup overloads only if Compare::is_transparent exists and K is no iterator, other keys are converted to the key type like in std::set
+            template<typename Compare, typename K, typename Iterator>
+            using _transparent_key_t = typename std::enable_if<!std::is_convertible<const K &, Iterator>::value,
+                                                               void_t<typename Compare::is_transparent>>::type;
+
+            //! Sorted vector of unique values used as storage of flat_set and flat_map
+            template<typename Value, typename KeyOf, typename Compare>
+            class _flat_tree {
+            public:
+                using value_type = Value;
+                using key_compare = Compare;
+                using size_type = std::size_t;
+                using container_type = std::vector<Value>;
+                using iterator = typename container_type::iterator;
+                using const_iterator = typename container_type::const_iterator;
+                using key_type = typename std::decay<decltype(std::declval<const KeyOf &>()(std::declval<const Value &>()))>::type;
+
+                _flat_tree() = default;
+
+                //! Constructs an empty container using the specified comparator
+                explicit _flat_tree(const Compare &comp)
+                        : comp(comp) {}
+
+                //! Constructs the container from the supplied values, the first of several equivalent values is kept
+                explicit _flat_tree(container_type &&values, const Compare &comp = Compare())
+                        : comp(comp) {
+                    merge_batch(std::move(values));
+                }
+
+                const_iterator begin() const { return values.begin(); }
+
+                const_iterator end() const { return values.end(); }
+
+                const_iterator cbegin() const { return values.cbegin(); }
+
+                const_iterator cend() const { return values.cend(); }
+
+                //! Returns the number of stored values
+                size_type size() const { return values.size(); }
+
+                //! Returns whether the container is empty
+                bool empty() const { return values.empty(); }
+
+                //! Removes all values
+                void clear() { values.clear(); }
+
+                //! Reserves storage for the specified number of values
+                void reserve(size_type n) { values.reserve(n); }
+
+                //! Returns the underlying sorted vector
+                const container_type &sequence() const { return values; }
+
+                //! Moves the underlying sorted vector out of the container and leaves the container empty
+                container_type extract() {
+                    container_type result = std::move(values);
+                    values.clear();
+                    return result;
+                }
+
+                //! Returns an iterator to the first value whose key is not less than the specified key
+                const_iterator lower_bound(const key_type &key) const { return lower_bound_of(key); }
+
+                //! Returns an iterator to the first value whose key is not less than the specified key, heterogeneous version for transparent comparators
+                template<typename K, typename C = Compare, typename = _transparent_key_t<C, K, const_iterator>>
+                const_iterator lower_bound(const K &key) const { return lower_bound_of(key); }
+
+                //! Returns an iterator to the first value whose key is greater than the specified key
+                const_iterator upper_bound(const key_type &key) const { return upper_bound_of(key); }
+
+                //! Returns an iterator to the first value whose key is greater than the specified key, heterogeneous version for transparent comparators
+                template<typename K, typename C = Compare, typename = _transparent_key_t<C, K, const_iterator>>
+                const_iterator upper_bound(const K &key) const { return upper_bound_of(key); }
+
+                //! Returns an iterator to the value with the specified key or end() if no such value exists
+                const_iterator find(const key_type &key) const { return find_of(key); }
+
+                //! Returns an iterator to the value with the specified key or end() if no such value exists, heterogeneous version for transparent comparators
+                template<typename K, typename C = Compare, typename = _transparent_key_t<C, K, const_iterator>>
+                const_iterator find(const K &key) const { return find_of(key); }
+
+                //! Returns whether a value with the specified key exists
+                bool contains(const key_type &key) const { return find_of(key) != values.end(); }
+
+                //! Returns whether a value with the specified key exists, heterogeneous version for transparent comparators
+                template<typename K, typename C = Compare, typename = _transparent_key_t<C, K, const_iterator>>
+                bool contains(const K &key) const { return find_of(key) != values.end(); }
+
+                //! Returns the number of values with the specified key, i.e. zero or one
+                size_type count(const key_type &key) const { return contains(key) ? 1 : 0; }
+
+                //! Returns the number of values with the specified key, i.e. zero or one, heterogeneous version for transparent comparators
+                template<typename K, typename C = Compare, typename = _transparent_key_t<C, K, const_iterator>>
+                size_type count(const K &key) const { return contains(key) ? 1 : 0; }
+
+                //! Inserts the value if no value with an equivalent key exists, returns the position of the value with the key and whether the value was inserted
+                std::pair<iterator, bool> insert(Value value) {
+                    auto it = mutable_iterator(lower_bound(key_of(value)));
+                    if (it != values.end() && !comp(key_of(value), key_of(*it))) return {it, false};
+                    return {values.insert(it, std::move(value)), true};
+                }
+
+                //! Inserts all values of the range whose keys are not yet present, the batch is sorted and merged in linear time
+                template<typename InputIt>
+                void insert(InputIt first, InputIt last) {
+                    merge_batch(container_type(first, last));
+                }
+
+                //! Inserts all values of the initializer list whose keys are not yet present
+                void insert(std::initializer_list<Value> batch) {
+                    insert(batch.begin(), batch.end());
+                }
+
+                //! Removes the value at the specified position, returns the iterator following the removed value
+                iterator erase(iterator pos) {
+                    return values.erase(pos);
+                }
+
+                //! Removes the value at the specified position, returns the iterator following the removed value
+                const_iterator erase(const_iterator pos) {
+                    return values.erase(pos);
+                }
+
+                //! Removes the value with the specified key, returns the number of removed values
+                size_type erase(const key_type &key) { return erase_key(key); }
+
+                //! Removes the value with the specified key, returns the number of removed values, heterogeneous version for transparent comparators
+                template<typename K, typename C = Compare, typename = _transparent_key_t<C, K, const_iterator>>
+                size_type erase(const K &key) { return erase_key(key); }
+
+                friend bool operator==(const _flat_tree &a, const _flat_tree &b) { return a.values == b.values; }
+
+                friend bool operator!=(const _flat_tree &a, const _flat_tree &b) { return a.values != b.values; }
+
+            protected:
+                template<typename K>
+                const_iterator lower_bound_of(const K &key) const {
+                    return std::lower_bound(values.begin(), values.end(), key,
+                                            [this](const Value &value, const K &k) { return comp(key_of(value), k); });
+                }
+
+                template<typename K>
+                const_iterator upper_bound_of(const K &key) const {
+                    return std::upper_bound(values.begin(), values.end(), key,
+                                            [this](const K &k, const Value &value) { return comp(k, key_of(value)); });
+                }
+
+                template<typename K>
+                const_iterator find_of(const K &key) const {
+                    const auto it = lower_bound_of(key);
+                    return (it != values.end() && !comp(key, key_of(*it))) ? it : values.end();
+                }
+
+                template<typename K>
+                size_type erase_key(const K &key) {
+                    const auto it = find_of(key);
+                    if (it == values.end()) return 0;
+                    values.erase(it);
+                    return 1;
+                }
+
+                //! Converts a const_iterator to an iterator
+                iterator mutable_iterator(const_iterator it) {
+                    return values.begin() + (it - values.cbegin());
+                }
+
+                //! Appends the batch, sorts it and merges it with the stored values, the first of several values with equivalent keys is kept
+                void merge_batch(container_type &&batch) {
+                    const auto value_comp = [this](const Value &a, const Value &b) { return comp(key_of(a), key_of(b)); };
+
+                    const auto old_size = static_cast<std::ptrdiff_t>(values.size());
+                    if (values.empty()) {
+                        values = std::move(batch);
+                    } else {
+                        values.insert(values.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+                    }
+
+                    // Stable sorting and merging keeps stored values and earlier batch values in front of equivalent ones
+                    std::stable_sort(values.begin() + old_size, values.end(), value_comp);
+                    std::inplace_merge(values.begin(), values.begin() + old_size, values.end(), value_comp);
+                    values.erase(std::unique(values.begin(), values.end(),
+                                             [&value_comp](const Value &a, const Value &b) { return !value_comp(a, b); }),
+                                 values.end());
+                }
+
+                container_type values;
+                Compare comp;
+                KeyOf key_of;
+            };
+        }
+
+        //! Set of unique keys stored contiguously in a sorted vector, supports heterogeneous lookup with transparent comparators
+        template<typename Key, typename Compare = std::less<Key>>
+        class flat_set : public _detail::_flat_tree<Key, _detail::_identity_key, Compare> {
+            using base = _detail::_flat_tree<Key, _detail::_identity_key, Compare>;
+
+        public:
+            using key_type = Key;
+            using iterator = typename base::const_iterator;
+
+            flat_set() = default;
+
+            //! Constructs an empty set using the specified comparator
+            explicit flat_set(const Compare &comp)
+                    : base(comp) {}
+
+            //! Constructs the set from the values of the vector
+            explicit flat_set(std::vector<Key> &&keys, const Compare &comp = Compare())
+                    : base(std::move(keys), comp) {}
+
+            //! Constructs the set from the values of the initializer list
+            flat_set(std::initializer_list<Key> keys, const Compare &comp = Compare())
+                    : base(std::vector<Key>(keys), comp) {}
+
+            //! Constructs the set from the values of the range
+            template<typename InputIt>
+            flat_set(InputIt first, InputIt last, const Compare &comp = Compare())
+                    : base(std::vector<Key>(first, last), comp) {}
+
+            //! Inserts the key if it is not present, returns its position and whether it was inserted
+            std::pair<iterator, bool> insert(Key key) {
+                const auto result = base::insert(std::move(key));
+                return {result.first, result.second};
+            }
+
+            using base::insert;
+        };
+
+        //! Map with unique keys stored contiguously as key-value pairs in a vector sorted by key, supports heterogeneous lookup with transparent comparators
+        template<typename Key, typename T, typename Compare = std::less<Key>>
+        class flat_map : public _detail::_flat_tree<std::pair<Key, T>, _detail::_first_key, Compare> {
+            using base = _detail::_flat_tree<std::pair<Key, T>, _detail::_first_key, Compare>;
+
+        public:
+            using key_type = Key;
+            using mapped_type = T;
+            using typename base::value_type;
+            using typename base::iterator;
+            using typename base::const_iterator;
+
+            flat_map() = default;
+
+            //! Constructs an empty map using the specified comparator
+            explicit flat_map(const Compare &comp)
+                    : base(comp) {}
+
+            //! Constructs the map from the key-value pairs of the vector
+            explicit flat_map(std::vector<value_type> &&pairs, const Compare &comp = Compare())
+                    : base(std::move(pairs), comp) {}
+
+            //! Constructs the map from the key-value pairs of the initializer list
+            flat_map(std::initializer_list<value_type> pairs, const Compare &comp = Compare())
+                    : base(std::vector<value_type>(pairs), comp) {}
+
+            //! Constructs the map from the key-value pairs of the range
+            template<typename InputIt>
+            flat_map(InputIt first, InputIt last, const Compare &comp = Compare())
+                    : base(std::vector<value_type>(first, last), comp) {}
+
+            iterator begin() { return this->values.begin(); }
+
+            iterator end() { return this->values.end(); }
+
+            using base::begin;
+            using base::end;
+
+            //! Returns an iterator to the pair with the specified key or end() if no such pair exists
+            iterator find(const Key &key) {
+                return this->mutable_iterator(this->find_of(key));
+            }
+
+            //! Returns an iterator to the pair with the specified key or end() if no such pair exists, heterogeneous version for transparent comparators
+            template<typename K, typename C = Compare, typename = _detail::_transparent_key_t<C, K, const_iterator>>
+            iterator find(const K &key) {
+                return this->mutable_iterator(this->find_of(key));
+            }
+
+            using base::find;
+
+            //! Returns the value mapped to the key, throws std::out_of_range if the key is not present
+            T &at(const Key &key) {
+                return mapped(key);
+            }
+
+            //! Returns the value mapped to the key, throws std::out_of_range if the key is not present, heterogeneous version for transparent comparators
+            template<typename K, typename C = Compare, typename = _detail::_transparent_key_t<C, K, const_iterator>>
+            T &at(const K &key) {
+                return mapped(key);
+            }
+
+            //! Returns the value mapped to the key, throws std::out_of_range if the key is not present
+            const T &at(const Key &key) const {
+                return mapped(key);
+            }
+
+            //! Returns the value mapped to the key, throws std::out_of_range if the key is not present, heterogeneous version for transparent comparators
+            template<typename K, typename C = Compare, typename = _detail::_transparent_key_t<C, K, const_iterator>>
+            const T &at(const K &key) const {
+                return mapped(key);
+            }
+
+            //! Returns the value mapped to the key, inserts a value initialized value if the key is not present
+            T &operator[](const Key &key) {
+                auto it = this->mutable_iterator(base::lower_bound(key));
+                if (it == this->values.end() || this->comp(key, it->first)) it = this->values.insert(it, value_type(key, T()));
+                return it->second;
+            }
+
+        private:
+            template<typename K>
+            T &mapped(const K &key) {
+                const auto it = this->find_of(key);
+                if (it == base::end()) throw std::out_of_range("flat_map::at: key not found");
+                return this->mutable_iterator(it)->second;
+            }
+
+            template<typename K>
+            const T &mapped(const K &key) const {
+                const auto it = this->find_of(key);
+                if (it == base::end()) throw std::out_of_range("flat_map::at: key not found");
+                return it->second;
+            }
+        };
+
+        namespace _detail {
+            //! Returns the number of trailing one bits of x
+            inline unsigned _count_trailing_ones(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+                return (~x == 0) ? 64u : static_cast<unsigned>(__builtin_ctzll(~x));
+#else
+                unsigned count = 0;
+                while (x & 1u) {
+                    x >>= 1;
+                    count++;
+                }
+                return count;
+#endif
+            }
+        }
+
+        //! Static search structure storing sorted values in Eytzinger (BFS) order, lower_bound searches are branchless and prefetch the nodes four levels ahead
+        /*
+         * The top levels of the implicit tree share a few cache lines and every search accesses the following levels in a predictable
+         * pattern, which makes lookups in data sets larger than the caches considerably faster than binary searches on the sorted values.
+         * The prefetch covers the first cache line of the 16 descendants four levels below the current node, i.e. all of them for
+         * values of up to 4 bytes and a correspondingly smaller part of them for larger values.
+         */
+        template<typename T, typename Compare = std::less<T>>
+        class eytzinger_tree {
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+
+            eytzinger_tree() = default;
+
+            //! Constructs the tree from a vector sorted with respect to comp
+            explicit eytzinger_tree(const std::vector<T> &sorted_values, const Compare &comp = Compare())
+                    : nodes(sorted_values.size() + 1), comp(comp) {
+                build(sorted_values, 0, 1);
+            }
+
+            //! Returns the number of stored values
+            size_type size() const { return nodes.size() - 1; }
+
+            //! Returns whether the tree is empty
+            bool empty() const { return nodes.size() == 1; }
+
+            //! Returns a pointer to the smallest value not less than the key or nullptr if all values are less than the key
+            template<typename K>
+            const T *lower_bound(const K &key) const {
+                const std::size_t k = search(key);
+                return (k != 0) ? &nodes[k] : nullptr;
+            }
+
+            //! Returns whether a value equivalent to the key is stored
+            template<typename K>
+            bool contains(const K &key) const {
+                const std::size_t k = search(key);
+                return k != 0 && !comp(key, nodes[k]);
+            }
+
+            //! Returns the stored values in Eytzinger order, the first entry is unused
+            const std::vector<T> &sequence() const { return nodes; }
+
+        private:
+            //! Number of descendants four levels below a node, they are stored contiguously starting at node index k * prefetch_stride
+            static constexpr std::size_t prefetch_stride = 16;
+
+            //! Fills the nodes of the subtree rooted at k with the values starting at sorted index i by in-order traversal, returns the next sorted index
+            std::size_t build(const std::vector<T> &sorted_values, std::size_t i, std::size_t k) {
+                if (k < nodes.size()) {
+                    i = build(sorted_values, i, 2 * k);
+                    nodes[k] = sorted_values[i++];
+                    i = build(sorted_values, i, 2 * k + 1);
+                }
+                return i;
+            }
+
+            //! Returns the node index of the lower bound of the key or zero if there is none
+            template<typename K>
+            std::size_t search(const K &key) const {
+                const T *data = nodes.data();
+                const std::size_t n = nodes.size() - 1;
+                std::size_t k = 1;
+                while (k <= n) {
+                    const std::size_t ahead = k * prefetch_stride;
+                    NONAME_PREFETCH(data + ((ahead <= n) ? ahead : 0));
+                    k = 2 * k + static_cast<std::size_t>(comp(data[k], key));
+                }
+                // The lower bound is the last node where the search descended to the left
+                return static_cast<std::size_t>(k >> (_detail::_count_trailing_ones(k) + 1));
+            }
+
+            std::vector<T> nodes = std::vector<T>(1);
+            Compare comp;
+        };
+
+        //! Vector which stores up to N elements inline without heap allocation and moves its elements to the heap once it grows beyond that
+        template<typename T, std::size_t N>
+        class small_vector {
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = T &;
+            using const_reference = const T &;
+            using pointer = T *;
+            using const_pointer = const T *;
+            using iterator = T *;
+            using const_iterator = const T *;
+
+            //! Number of elements that can be stored without heap allocation
+            static constexpr size_type inline_capacity = N;
+
+            small_vector() = default;
+
+            //! Constructs the vector with count value initialized elements
+            explicit small_vector(size_type count) {
+                resize(count);
+            }
+
+            //! Constructs the vector with count copies of value
+            small_vector(size_type count, const T &value) {
+                resize(count, value);
+            }
+
+            //! Constructs the vector from the values of the initializer list
+            small_vector(std::initializer_list<T> values)
+                    : small_vector(values.begin(), values.end()) {}
+
+            //! Constructs the vector from the values of the range
+            template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+            small_vector(InputIt first, InputIt last) {
+                for (; first != last; ++first) emplace_back(*first);
+            }
+
+            small_vector(const small_vector &other)
+                    : small_vector(other.begin(), other.end()) {}
+
+            //! Steals the heap storage of other or moves its inline elements
+            small_vector(small_vector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+                take(std::move(other));
+            }
+
+            ~small_vector() {
+                clear();
+                release();
+            }
+
+            small_vector &operator=(const small_vector &other) {
+                if (this != &other) {
+                    clear();
+                    reserve(other.size());
+                    for (const auto &value : other) emplace_back(value);
+                }
+                return *this;
+            }
+
+            small_vector &operator=(small_vector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+                if (this != &other) {
+                    clear();
+                    release();
+                    take(std::move(other));
+                }
+                return *this;
+            }
+
+            iterator begin() { return elements; }
+
+            iterator end() { return elements + count; }
+
+            const_iterator begin() const { return elements; }
+
+            const_iterator end() const { return elements + count; }
+
+            const_iterator cbegin() const { return elements; }
+
+            const_iterator cend() const { return elements + count; }
+
+            T *data() { return elements; }
+
+            const T *data() const { return elements; }
+
+            size_type size() const { return count; }
+
+            size_type capacity() const { return storage_capacity; }
+
+            bool empty() const { return count == 0; }
+
+            //! Returns whether the elements are stored in the inline storage
+            bool is_inline() const { return elements == inline_data(); }
+
+            T &operator[](size_type i) { return elements[i]; }
+
+            const T &operator[](size_type i) const { return elements[i]; }
+
+            //! Returns the element at the specified position, throws std::out_of_range if the position is invalid
+            T &at(size_type i) {
+                if (i >= count) throw std::out_of_range("small_vector::at: index out of range");
+                return elements[i];
+            }
+
+            //! Returns the element at the specified position, throws std::out_of_range if the position is invalid
+            const T &at(size_type i) const {
+                if (i >= count) throw std::out_of_range("small_vector::at: index out of range");
+                return elements[i];
+            }
+
+            T &front() { return elements[0]; }
+
+            const T &front() const { return elements[0]; }
+
+            T &back() { return elements[count - 1]; }
+
+            const T &back() const { return elements[count - 1]; }
+
+            //! Ensures that at least new_capacity elements can be stored without reallocation
+            void reserve(size_type new_capacity) {
+                if (new_capacity > storage_capacity) reallocate(new_capacity);
+            }
+
+            //! Constructs an element in place at the end, doubles the capacity if the storage is full
+            template<typename... Args>
+            T &emplace_back(Args &&... args) {
+                if (count == storage_capacity) {
+                    // Construct the new element first, the arguments may refer to elements of the vector
+                    T value(std::forward<Args>(args)...);
+                    reallocate(std::max<size_type>(2 * storage_capacity, 1));
+                    ::new(static_cast<void *>(elements + count)) T(std::move(value));
+                } else {
+                    ::new(static_cast<void *>(elements + count)) T(std::forward<Args>(args)...);
+                }
+                return elements[count++];
+            }
+
+            void push_back(const T &value) { emplace_back(value); }
+
+            void push_back(T &&value) { emplace_back(std::move(value)); }
+
+            void pop_back() { elements[--count].~T(); }
+
+            //! Removes the element at pos and returns an iterator to the following element
+            iterator erase(const_iterator pos) {
+                return erase(pos, pos + 1);
+            }
+
+            //! Removes the elements of the range and returns an iterator to the element following them
+            iterator erase(const_iterator first, const_iterator last) {
+                const auto i = static_cast<size_type>(first - elements);
+                const auto removed = static_cast<size_type>(last - first);
+                std::move(elements + i + removed, elements + count, elements + i);
+                for (size_type k = 0; k < removed; ++k) pop_back();
+                return elements + i;
+            }
+
+            //! Changes the number of elements, appends value initialized elements if the vector grows
+            void resize(size_type new_size) {
+                reserve(new_size);
+                while (count > new_size) pop_back();
+                while (count < new_size) emplace_back();
+            }
+
+            //! Changes the number of elements, appends copies of value if the vector grows
+            void resize(size_type new_size, const T &value) {
+                reserve(new_size);
+                while (count > new_size) pop_back();
+                while (count < new_size) emplace_back(value);
+            }
+
+            //! Destroys all elements, keeps the current storage
+            void clear() {
+                while (count > 0) pop_back();
+            }
+
+            bool operator==(const small_vector &other) const {
+                return std::equal(begin(), end(), other.begin(), other.end());
+            }
+
+            bool operator!=(const small_vector &other) const {
+                return !(*this == other);
+            }
+
+        private:
+            using storage_t = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+            T *inline_data() { return reinterpret_cast<T *>(inline_storage); }
+
+            const T *inline_data() const { return reinterpret_cast<const T *>(inline_storage); }
+
+            //! Moves the elements to a new heap storage of the specified capacity
+            void reallocate(size_type new_capacity) {
+                std::allocator<T> allocator;
+                T *new_elements = allocator.allocate(new_capacity);
+                for (size_type i = 0; i < count; ++i) {
+                    ::new(static_cast<void *>(new_elements + i)) T(std::move(elements[i]));
+                    elements[i].~T();
+                }
+                release();
+                elements = new_elements;
+                storage_capacity = new_capacity;
+            }
+
+            //! Returns the heap storage to the allocator, the elements have to be destroyed before
+            void release() {
+                if (!is_inline()) std::allocator<T>().deallocate(elements, storage_capacity);
+                elements = inline_data();
+                storage_capacity = N;
+            }
+
+            //! Takes over the elements of other which is left empty, the own storage has to be inline and empty
+            void take(small_vector &&other) {
+                if (other.is_inline()) {
+                    for (size_type i = 0; i < other.count; ++i) ::new(static_cast<void *>(elements + i)) T(std::move(other.elements[i]));
+                    count = other.count;
+                    other.clear();
+                } else {
+                    elements = other.elements;
+                    storage_capacity = other.storage_capacity;
+                    count = other.count;
+                    other.elements = other.inline_data();
+                    other.storage_capacity = N;
+                    other.count = 0;
+                }
+            }
+
+            storage_t inline_storage[(N > 0) ? N : 1];
+            T *elements = inline_data();
+            size_type count = 0;
+            size_type storage_capacity = N;
+        };
+
+        template<typename T, std::size_t N>
+        constexpr typename small_vector<T, N>::size_type small_vector<T, N>::inline_capacity;
+
+        namespace _detail {
+            //! Random access iterator over the elements of a segmented_vector
+            template<typename Container, typename T>
+            class _segmented_iterator {
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = typename std::remove_const<T>::type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = T *;
+                using reference = T &;
+
+                _segmented_iterator() = default;
+
+                _segmented_iterator(Container *container, std::size_t index)
+                        : container(container), index(index) {}
+
+                //! Allows conversion of mutable iterators to const iterators
+                template<typename OtherContainer, typename OtherT,
+                        typename = typename std::enable_if<std::is_convertible<OtherT *, T *>::value>::type>
+                _segmented_iterator(const _segmented_iterator<OtherContainer, OtherT> &other)
+                        : container(other.container), index(other.index) {}
+
+                reference operator*() const { return (*container)[index]; }
+
+                pointer operator->() const { return &(*container)[index]; }
+
+                reference operator[](difference_type n) const { return (*container)[index + n]; }
+
+                _segmented_iterator &operator++() {
+                    ++index;
+                    return *this;
+                }
+
+                _segmented_iterator operator++(int) {
+                    auto copy = *this;
+                    ++index;
+                    return copy;
+                }
+
+                _segmented_iterator &operator--() {
+                    --index;
+                    return *this;
+                }
+
+                _segmented_iterator operator--(int) {
+                    auto copy = *this;
+                    --index;
+                    return copy;
+                }
+
+                _segmented_iterator &operator+=(difference_type n) {
+                    index += n;
+                    return *this;
+                }
+
+                _segmented_iterator &operator-=(difference_type n) {
+                    index -= n;
+                    return *this;
+                }
+
+                friend _segmented_iterator operator+(_segmented_iterator it, difference_type n) { return it += n; }
+
+                friend _segmented_iterator operator+(difference_type n, _segmented_iterator it) { return it += n; }
+
+                friend _segmented_iterator operator-(_segmented_iterator it, difference_type n) { return it -= n; }
+
+                friend difference_type operator-(const _segmented_iterator &lhs, const _segmented_iterator &rhs) {
+                    return static_cast<difference_type>(lhs.index) - static_cast<difference_type>(rhs.index);
+                }
+
+                friend bool operator==(const _segmented_iterator &lhs, const _segmented_iterator &rhs) { return lhs.index == rhs.index; }
+
+                friend bool operator!=(const _segmented_iterator &lhs, const _segmented_iterator &rhs) { return lhs.index != rhs.index; }
+
+                friend bool operator<(const _segmented_iterator &lhs, const _segmented_iterator &rhs) { return lhs.index < rhs.index; }
+
+                friend bool operator>(const _segmented_iterator &lhs, const _segmented_iterator &rhs) { return lhs.index > rhs.index; }
+
+                friend bool operator<=(const _segmented_iterator &lhs, const _segmented_iterator &rhs) { return lhs.index <= rhs.index; }
+
+                friend bool operator>=(const _segmented_iterator &lhs, const _segmented_iterator &rhs) { return lhs.index >= rhs.index; }
+
+            private:
+                template<typename, typename>
+                friend class _segmented_iterator;
+
+                Container *container = nullptr;
+                std::size_t index = 0;
+            };
+        }
+
+        //! Vector storing its elements in fixed-size blocks of BlockSize elements, elements are never moved when the vector grows so their addresses stay valid
+        /*
+         * Random access only needs one additional indirection through the block table and growing the vector only appends
+         * a block, which avoids the copies and the peak memory of a std::vector reallocation for very large element counts.
+         */
+        template<typename T, std::size_t BlockSize = 1024>
+        class segmented_vector {
+            static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "The block size has to be a power of two.");
+
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = T &;
+            using const_reference = const T &;
+            using iterator = _detail::_segmented_iterator<segmented_vector, T>;
+            using const_iterator = _detail::_segmented_iterator<const segmented_vector, const T>;
+
+            //! Number of elements per block
+            static constexpr size_type block_size = BlockSize;
+
+            segmented_vector() = default;
+
+            //! Constructs the vector from the values of the initializer list
+            segmented_vector(std::initializer_list<T> values) {
+                for (const auto &value : values) emplace_back(value);
+            }
+
+            //! Constructs the vector from the values of the range
+            template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+            segmented_vector(InputIt first, InputIt last) {
+                for (; first != last; ++first) emplace_back(*first);
+            }
+
+            segmented_vector(const segmented_vector &other)
+                    : segmented_vector(other.begin(), other.end()) {}
+
+            //! Takes over the blocks of other without touching its elements
+            segmented_vector(segmented_vector &&other) noexcept
+                    : blocks(std::move(other.blocks)), count(other.count) {
+                other.blocks.clear();
+                other.count = 0;
+            }
+
+            ~segmented_vector() {
+                clear();
+            }
+
+            segmented_vector &operator=(const segmented_vector &other) {
+                if (this != &other) {
+                    clear();
+                    for (const auto &value : other) emplace_back(value);
+                }
+                return *this;
+            }
+
+            segmented_vector &operator=(segmented_vector &&other) noexcept {
+                if (this != &other) {
+                    clear();
+                    blocks = std::move(other.blocks);
+                    count = other.count;
+                    other.blocks.clear();
+                    other.count = 0;
+                }
+                return *this;
+            }
+
+            iterator begin() { return iterator(this, 0); }
+
+            iterator end() { return iterator(this, count); }
+
+            const_iterator begin() const { return const_iterator(this, 0); }
+
+            const_iterator end() const { return const_iterator(this, count); }
+
+            const_iterator cbegin() const { return begin(); }
+
+            const_iterator cend() const { return end(); }
+
+            size_type size() const { return count; }
+
+            bool empty() const { return count == 0; }
+
+            //! Returns the number of elements that can be stored without allocating another block
+            size_type capacity() const { return blocks.size() * BlockSize; }
+
+            T &operator[](size_type i) { return element(i); }
+
+            const T &operator[](size_type i) const { return element(i); }
+
+            //! Returns the element at the specified position, throws std::out_of_range if the position is invalid
+            T &at(size_type i) {
+                if (i >= count) throw std::out_of_range("segmented_vector::at: index out of range");
+                return element(i);
+            }
+
+            //! Returns the element at the specified position, throws std::out_of_range if the position is invalid
+            const T &at(size_type i) const {
+                if (i >= count) throw std::out_of_range("segmented_vector::at: index out of range");
+                return element(i);
+            }
+
+            T &front() { return element(0); }
+
+            const T &front() const { return element(0); }
+
+            T &back() { return element(count - 1); }
+
+            const T &back() const { return element(count - 1); }
+
+            //! Allocates blocks until at least new_capacity elements can be stored
+            void reserve(size_type new_capacity) {
+                while (capacity() < new_capacity) blocks.emplace_back(new storage_t[BlockSize]);
+            }
+
+            //! Constructs an element in place at the end, allocates a new block if the last one is full
+            template<typename... Args>
+            T &emplace_back(Args &&... args) {
+                if (count == capacity()) blocks.emplace_back(new storage_t[BlockSize]);
+                T *p = ::new(static_cast<void *>(&blocks[count / BlockSize][count % BlockSize])) T(std::forward<Args>(args)...);
+                ++count;
+                return *p;
+            }
+
+            void push_back(const T &value) { emplace_back(value); }
+
+            void push_back(T &&value) { emplace_back(std::move(value)); }
+
+            void pop_back() { element(--count).~T(); }
+
+            //! Destroys all elements, keeps the allocated blocks
+            void clear() {
+                while (count > 0) pop_back();
+            }
+
+            //! Releases the blocks that do not contain any elements
+            void shrink_to_fit() {
+                blocks.resize((count + BlockSize - 1) / BlockSize);
+                blocks.shrink_to_fit();
+            }
+
+            //! Appends all elements of other, whose blocks are taken over without moving elements if this vector ends at a block boundary
+            void append(segmented_vector &&other) {
+                if (&other == this) return;
+                if (count % BlockSize == 0) {
+                    blocks.resize(count / BlockSize);
+                    for (auto &block : other.blocks) blocks.push_back(std::move(block));
+                    count += other.count;
+                } else {
+                    for (auto &value : other) emplace_back(std::move(value));
+                    other.clear();
+                }
+                other.blocks.clear();
+                other.count = 0;
+            }
+
+        private:
+            using storage_t = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+            T &element(size_type i) {
+                return *reinterpret_cast<T *>(&blocks[i / BlockSize][i % BlockSize]);
+            }
+
+            const T &element(size_type i) const {
+                return *reinterpret_cast<const T *>(&blocks[i / BlockSize][i % BlockSize]);
+            }
+
+            std::vector<std::unique_ptr<storage_t[]>> blocks;
+            size_type count = 0;
+        };
+
+        template<typename T, std::size_t BlockSize>
+        constexpr typename segmented_vector<T, BlockSize>::size_type segmented_vector<T, BlockSize>::block_size;
+
+        namespace _detail {
+            //! Returns the index of the highest set bit of x, x has to be non-zero
+            inline unsigned _floor_log2(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+                return 63u - static_cast<unsigned>(__builtin_clzll(x));
+#else
+                unsigned log = 0;
+                while (x >>= 1) log++;
+                return log;
+#endif
+            }
+        }
+
+        //! Append-only vector which can be filled concurrently by many threads, indices are claimed atomically and the elements are stored in geometrically growing blocks that are never moved
+        /*
+         * Block 0 holds the first FirstBlockSize elements and every following block is as large as all previous blocks
+         * together, so the block of an index is found by a single bit scan. Appends only synchronize through one atomic
+         * counter and the compare-exchange that publishes a new block. Elements may only be read once the threads
+         * appending them have been synchronized with, e.g. after a parallel_for returned. An index is only claimed once
+         * its element can be constructed without throwing, so elements whose construction may throw are built in a
+         * temporary first and moved into their slot.
+         */
+        template<typename T, std::size_t FirstBlockSize = 64>
+        class concurrent_append_vector {
+            static_assert(FirstBlockSize > 0 && (FirstBlockSize & (FirstBlockSize - 1)) == 0, "The first block size has to be a power of two.");
+            static_assert(std::is_nothrow_move_constructible<T>::value, "The elements have to be nothrow move constructible.");
+
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = T &;
+            using const_reference = const T &;
+            using iterator = _detail::_segmented_iterator<concurrent_append_vector, T>;
+            using const_iterator = _detail::_segmented_iterator<const concurrent_append_vector, const T>;
+
+            //! Per-thread front-end which collects elements locally and appends them with a single index claim per batch
+            class appender {
+            public:
+                //! Creates an appender which claims indices for batch_size elements at once
+                explicit appender(concurrent_append_vector &target, size_type batch_size = FirstBlockSize)
+                        : target(&target), batch_size(std::max<size_type>(batch_size, 1)) {
+                    buffer.reserve(this->batch_size);
+                }
+
+                appender(appender &&) = default;
+
+                ~appender() {
+                    flush();
+                }
+
+                template<typename... Args>
+                void emplace_back(Args &&... args) {
+                    buffer.emplace_back(std::forward<Args>(args)...);
+                    if (buffer.size() == batch_size) flush();
+                }
+
+                void push_back(const T &value) { emplace_back(value); }
+
+                void push_back(T &&value) { emplace_back(std::move(value)); }
+
+                //! Appends all buffered elements to the vector
+                void flush() {
+                    if (buffer.empty()) return;
+                    target->append(std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()));
+                    buffer.clear();
+                }
+
+                //! Returns an output iterator which appends assigned values through this appender
+                auto output_iterator() {
+                    return make_output_iterator_adapter([this](auto &&value) { this->push_back(std::forward<decltype(value)>(value)); });
+                }
+
+            private:
+                concurrent_append_vector *target;
+                size_type batch_size;
+                std::vector<T> buffer;
+            };
+
+            concurrent_append_vector() {
+                for (auto &block : blocks) block.store(nullptr, std::memory_order_relaxed);
+            }
+
+            concurrent_append_vector(const concurrent_append_vector &) = delete;
+
+            concurrent_append_vector &operator=(const concurrent_append_vector &) = delete;
+
+            ~concurrent_append_vector() {
+                clear();
+                for (size_type k = 0; k < blocks.size(); ++k) {
+                    storage_t *block = blocks[k].load(std::memory_order_relaxed);
+                    if (block != nullptr) std::allocator<storage_t>().deallocate(block, block_capacity(k));
+                }
+            }
+
+            //! Constructs an element at the end of the vector and returns its index, may be called concurrently
+            template<typename... Args>
+            size_type emplace_back(Args &&... args) {
+                return emplace_back_impl(bool_constant<std::is_nothrow_constructible<T, Args &&...>::value>(), std::forward<Args>(args)...);
+            }
+
+            //! Appends the value and returns its index, may be called concurrently
+            size_type push_back(const T &value) { return emplace_back(value); }
+
+            //! Appends the value and returns its index, may be called concurrently
+            size_type push_back(T &&value) { return emplace_back(std::move(value)); }
+
+            //! Appends the elements of the range at consecutive indices claimed at once and returns the first index, may be called concurrently
+            template<typename ForwardIt>
+            size_type append(ForwardIt first, ForwardIt last) {
+                return append_impl(first, last, bool_constant<std::is_nothrow_constructible<T, typename std::iterator_traits<ForwardIt>::reference>::value>());
+            }
+
+            //! Returns an appender which batches the index claims of one thread
+            appender make_appender(size_type batch_size = FirstBlockSize) {
+                return appender(*this, batch_size);
+            }
+
+            //! Returns an output iterator which appends every assigned value directly, may be used concurrently
+            auto output_iterator() {
+                return make_output_iterator_adapter([this](auto &&value) { this->push_back(std::forward<decltype(value)>(value)); });
+            }
+
+            //! Returns the number of claimed indices, equals the number of elements once all appending threads have finished
+            size_type size() const { return count.load(std::memory_order_acquire); }
+
+            bool empty() const { return size() == 0; }
+
+            T &operator[](size_type i) { return *reinterpret_cast<T *>(locate(i)); }
+
+            const T &operator[](size_type i) const { return *reinterpret_cast<const T *>(locate(i)); }
+
+            iterator begin() { return iterator(this, 0); }
+
+            iterator end() { return iterator(this, size()); }
+
+            const_iterator begin() const { return const_iterator(this, 0); }
+
+            const_iterator end() const { return const_iterator(this, size()); }
+
+            //! Destroys all elements and keeps the blocks, must not be called concurrently with any other member function
+            void clear() {
+                const size_type n = count.load(std::memory_order_relaxed);
+                for (size_type i = 0; i < n; ++i) (*this)[i].~T();
+                count.store(0, std::memory_order_relaxed);
+            }
+
+        private:
+            using storage_t = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+            template<typename... Args>
+            size_type emplace_back_impl(std::true_type /* nothrow */, Args &&... args) {
+                const size_type i = count.fetch_add(1, std::memory_order_relaxed);
+                ::new(static_cast<void *>(slot(i))) T(std::forward<Args>(args)...);
+                return i;
+            }
+
+            template<typename... Args>
+            size_type emplace_back_impl(std::false_type /* nothrow */, Args &&... args) {
+                return emplace_back_impl(std::true_type(), T(std::forward<Args>(args)...));
+            }
+
+            template<typename ForwardIt>
+            size_type append_impl(ForwardIt first, ForwardIt last, std::true_type /* nothrow */) {
+                const auto n = static_cast<size_type>(std::distance(first, last));
+                const size_type start = count.fetch_add(n, std::memory_order_relaxed);
+                for (size_type i = start; first != last; ++first, ++i) ::new(static_cast<void *>(slot(i))) T(*first);
+                return start;
+            }
+
+            template<typename ForwardIt>
+            size_type append_impl(ForwardIt first, ForwardIt last, std::false_type /* nothrow */) {
+                std::vector<T> values(first, last);
+                return append_impl(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()), std::true_type());
+            }
+
+            static constexpr unsigned first_block_log2() {
+                unsigned log = 0;
+                while ((std::size_t(1) << log) < FirstBlockSize) ++log;
+                return log;
+            }
+
+            //! Returns the block containing index i
+            static size_type block_index(size_type i) {
+                const std::uint64_t high = static_cast<std::uint64_t>(i) >> first_block_log2();
+                return (high == 0) ? 0 : _detail::_floor_log2(high) + 1;
+            }
+
+            //! Returns the number of elements stored in block k
+            static size_type block_capacity(size_type k) {
+                return (k == 0) ? FirstBlockSize : (FirstBlockSize << (k - 1));
+            }
+
+            //! Returns the first index stored in block k
+            static size_type block_start(size_type k) {
+                return (k == 0) ? 0 : (FirstBlockSize << (k - 1));
+            }
+
+            //! Returns the storage of index i, the block has to exist
+            storage_t *locate(size_type i) const {
+                const size_type k = block_index(i);
+                return blocks[k].load(std::memory_order_acquire) + (i - block_start(k));
+            }
+
+            //! Returns the storage of index i and allocates its block if necessary
+            storage_t *slot(size_type i) {
+                const size_type k = block_index(i);
+                storage_t *block = blocks[k].load(std::memory_order_acquire);
+                if (block == nullptr) {
+                    // Threads racing for the same block allocate it concurrently, only the first one publishes its allocation
+                    storage_t *allocated = std::allocator<storage_t>().allocate(block_capacity(k));
+                    if (blocks[k].compare_exchange_strong(block, allocated, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        block = allocated;
+                    } else {
+                        std::allocator<storage_t>().deallocate(allocated, block_capacity(k));
+                    }
+                }
+                return block + (i - block_start(k));
+            }
+
+            std::array<std::atomic<storage_t *>, 64 - first_block_log2()> blocks;
+            std::atomic<size_type> count{0};
+        };
+    }
+}
@@ -26,6 +26,9 @@
 #include <string>
 #include <fstream>
 
+#include "container_tools.h"
+#include "memory_tools.h"
+
 namespace noname {
     namespace tools {
         // TODO: Make methods templated in string type
@@ -54,6 +57,18 @@ namespace noname {
             return lines;
         }
 
+        //! Reads all lines from the specified file to a vector, the vector and the strings obtain their memory from the supplied allocator
+        template<typename Allocator, typename = _detail::_allocator_t<Allocator>>
+        alloc_vector_t<alloc_string_t<Allocator>, Allocator> read_all_lines(const std::string &file_path, const Allocator &alloc) {
+            const rebind_alloc_t<Allocator, char> char_alloc(alloc);
+            alloc_vector_t<alloc_string_t<Allocator>, Allocator> lines(alloc);
+            alloc_string_t<Allocator> currentLine(char_alloc);
+            std::ifstream file(file_path);
+            while (std::getline(file, currentLine)) lines.push_back(std::move(currentLine));
+            file.close();
+            return lines;
+        }
+
         //! Reads the specified number of lines from a file or reads the whole file if number of lines is zero
         inline std::vector<std::string> read_lines(const std::string &file_path, const size_t number_of_lines = 0) {
             if (number_of_lines == 0) return read_all_lines(file_path);
@@ -71,5 +86,47 @@ namespace noname {
             file.close();
             return lines;
         }
+
+        //! Reads the specified number of lines from a file or reads the whole file if number of lines is zero, the vector and the strings obtain their memory from the supplied allocator
+        template<typename Allocator, typename = _detail::_allocator_t<Allocator>>
+        alloc_vector_t<alloc_string_t<Allocator>, Allocator> read_lines(const std::string &file_path, const size_t number_of_lines, const Allocator &alloc) {
+            if (number_of_lines == 0) return read_all_lines(file_path, alloc);
+
+            const rebind_alloc_t<Allocator, char> char_alloc(alloc);
+            alloc_vector_t<alloc_string_t<Allocator>, Allocator> lines(alloc);
+            lines.reserve(number_of_lines);
+
+            alloc_string_t<Allocator> currentLine(char_alloc);
+            std::ifstream file(file_path);
+            size_t counter = 0;
+            while (counter < number_of_lines && std::getline(file, currentLine)) {
+                lines.push_back(std::move(currentLine));
+                counter++;
+            }
+            file.close();
+            return lines;
+        }
+
+        //! Appends the specified number of lines from a file or all lines if number of lines is zero to the segmented vector, returns the number of lines read
+        template<std::size_t BlockSize>
+        size_t read_lines(const std::string &file_path, const size_t number_of_lines, segmented_vector<std::string, BlockSize> &lines) {
+            std::ifstream file(file_path);
+            size_t counter = 0;
+            while (number_of_lines == 0 || counter < number_of_lines) {
+                if (!std::getline(file, lines.emplace_back())) {
+                    lines.pop_back();
+                    break;
+                }
+                counter++;
+            }
+            file.close();
+            return counter;
+        }
+
+        //! Appends all lines from the specified file to the segmented vector, every line is read directly into its final element, returns the number of lines read
+        template<std::size_t BlockSize>
+        size_t read_all_lines(const std::string &file_path, segmented_vector<std::string, BlockSize> &lines) {
+            return read_lines(file_path, 0, lines);
+        }
     }
 }
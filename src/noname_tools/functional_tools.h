@@ -23,12 +23,21 @@
 //	SOFTWARE.
 
 #include <utility>
+#include <iterator>
+#include <type_traits>
+#include <new>
 
 #include "tuple_tools.h"
 
 namespace noname {
     namespace tools {
         namespace _detail {
+            //! Returns the value itself as its key, used by flat_set, count_by_key and merge_join
+            struct _identity_key {
+                template<typename T>
+                const T &operator()(const T &value) const { return value; }
+            };
+
             template<typename F, typename T, T... Is>
             constexpr decltype(auto) apply_integer_sequence_impl(F&& f, std::integer_sequence<T, Is...>) {
                 return f(std::integral_constant<T, Is>{}...);
@@ -59,5 +68,56 @@ namespace noname {
                 return *this;
             }
         };
+
+        namespace _detail {
+            //! Output iterator adapter which forwards to a callable
+            template<typename Func>
+            struct _output_iterator_adapter {
+                using value_type = void;
+                using difference_type = void;
+                using pointer = void;
+                using reference = void;
+                using iterator_category = std::output_iterator_tag;
+
+                //! The callable used for the output iterator
+                callable_container<Func> f;
+
+                //! Assignment operator to emulate output iterators, forwards its argument to the stored callable
+                template<typename T,
+                        /* Use SFINAE to avoid confusion with copy-assignment operator */
+                        typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, _output_iterator_adapter>::value>::type>
+                _output_iterator_adapter &operator=(const T &value) {
+                    f.callable(value);
+                    return *this;
+                }
+
+                //! Assignment operator to emulate output iterators, forwards its argument to the stored callable
+                template<typename T,
+                        /* Use SFINAE to avoid confusion with copy-assignment operator */
+                        typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, _output_iterator_adapter>::value>::type>
+                _output_iterator_adapter &operator=(T &&value) {
+                    f.callable(std::forward<T>(value));
+                    return *this;
+                }
+
+                //! No-op, function is provided to satisfy the requirements of OutputIterator
+                _output_iterator_adapter &operator*() { return *this; }
+
+                //! No-op, function is provided to satisfy the requirements of OutputIterator
+                _output_iterator_adapter &operator++() { return *this; }
+
+                //! No-op, function is provided to satisfy the requirements of OutputIterator
+                _output_iterator_adapter &operator++(int) { return *this; }
+            };
+        }
+
+        //! Returns an OutputIterator like type which forwards output assignments to the supplied callable.
+        /*
+        * Construction, copy construction, destruction etc. of the callable may not have any side effects.
+        */
+        template<typename Func>
+        auto make_output_iterator_adapter(Func f) {
+            return _detail::_output_iterator_adapter<typename std::decay<Func>::type>{std::forward<Func>(f)};
+        }
     }
 }
@@ -24,6 +24,15 @@
 
 #define NONAME_ASSERT(x, m) ((x) ? (void)0 : (std::fprintf(stderr, "%s\n", m), std::abort()))
 
+#if defined(__GNUC__) || defined(__clang__)
+#define NONAME_PREFETCH(ptr) __builtin_prefetch(ptr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define NONAME_PREFETCH(ptr) _mm_prefetch(reinterpret_cast<const char *>(ptr), _MM_HINT_T0)
+#else
+#define NONAME_PREFETCH(ptr) ((void)0)
+#endif
+
 #ifndef NONAME_CPP14
 
 #ifndef NONAME_CPP17
@@ -0,0 +1,388 @@
+#pragma once
+
+//	MIT License
+//
+//	Copyright (c) 2020 Fabian Löschner
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <array>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "general_defs.h"
+
+// Depends on the language version actually used instead of NONAME_CPP17, which is also defined by default in C++14 builds
+#if (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)) && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define NONAME_HAS_MEMORY_RESOURCE
+#endif
+#endif
+
+namespace noname {
+    namespace tools {
+        //! Allocator type obtained by rebinding Allocator to the value type T
+        template<typename Allocator, typename T>
+        using rebind_alloc_t = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+        //! Vector of T using the allocator obtained by rebinding Allocator
+        template<typename T, typename Allocator>
+        using alloc_vector_t = std::vector<T, rebind_alloc_t<Allocator, T>>;
+
+        //! String of CharT using the allocator obtained by rebinding Allocator
+        template<typename Allocator, typename CharT = char, typename Traits = std::char_traits<CharT>>
+        using alloc_string_t = std::basic_string<CharT, Traits, rebind_alloc_t<Allocator, CharT>>;
+
+        namespace _detail {
+            //! Only valid for types providing allocate(n) like an allocator, used to constrain overloads taking an allocator
+            template<typename Allocator>
+            using _allocator_t = decltype(std::declval<Allocator &>().allocate(std::size_t(1)));
+
+            //! Rounds the address up to the next multiple of the power of two alignment
+            inline std::uintptr_t _align_up(std::uintptr_t address, std::size_t alignment) {
+                return (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+            }
+
+            //! Size of a bookkeeping header placed in front of memory obtained from operator new, keeps the following bytes maximally aligned
+            template<typename Header>
+            constexpr std::size_t _header_size() {
+                return (sizeof(Header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+            }
+        }
+
+        //! Memory resource which hands out memory by bumping a pointer through geometrically growing blocks, deallocation is a no-op and all memory is released at once by reset()
+        /*
+         * Under C++17 the arena is a std::pmr::memory_resource and can be used with std::pmr containers, otherwise it provides
+         * the same allocate/deallocate interface for use with arena_allocator. The memory of the arena may only be reset or
+         * released after all objects allocated from it have been destroyed.
+         */
+        class monotonic_arena
+#ifdef NONAME_HAS_MEMORY_RESOURCE
+                : public std::pmr::memory_resource
+#endif
+        {
+        public:
+            //! Default size of the first block in bytes
+            static constexpr std::size_t default_block_size = 64 * 1024;
+
+            //! Creates an empty arena whose first block will have the specified size
+            explicit monotonic_arena(std::size_t initial_block_size = default_block_size)
+                    : next_block_size(std::max<std::size_t>(initial_block_size, 1)) {}
+
+            monotonic_arena(const monotonic_arena &) = delete;
+
+            monotonic_arena &operator=(const monotonic_arena &) = delete;
+
+            ~monotonic_arena() {
+                release();
+            }
+
+#ifndef NONAME_HAS_MEMORY_RESOURCE
+            //! Returns memory of the specified size and power of two alignment
+            void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+                return allocate_bytes(bytes, alignment);
+            }
+
+            //! Does nothing, the memory is reclaimed by reset() or release()
+            void deallocate(void *, std::size_t, std::size_t = alignof(std::max_align_t)) {}
+#endif
+
+            //! Makes all memory available again while keeping the largest block, invalidates all previous allocations
+            void reset() {
+                if (current == nullptr) return;
+                free_blocks(current->previous);
+                current->previous = nullptr;
+                cursor = block_data(current);
+                bytes_used = 0;
+                bytes_reserved = current->size;
+            }
+
+            //! Returns all blocks to the system, invalidates all previous allocations
+            void release() {
+                free_blocks(current);
+                current = nullptr;
+                cursor = 0;
+                limit = 0;
+                bytes_used = 0;
+                bytes_reserved = 0;
+            }
+
+            //! Returns the number of bytes handed out since the last reset
+            std::size_t bytes_allocated() const { return bytes_used; }
+
+            //! Returns the total size of the blocks held by the arena in bytes
+            std::size_t bytes_held() const { return bytes_reserved; }
+
+        private:
+            struct _block_header {
+                _block_header *previous;
+                std::size_t size;
+            };
+
+            static std::uintptr_t block_data(_block_header *block) {
+                return reinterpret_cast<std::uintptr_t>(block) + _detail::_header_size<_block_header>();
+            }
+
+            void *allocate_bytes(std::size_t bytes, std::size_t alignment) {
+                std::uintptr_t aligned = _detail::_align_up(cursor, alignment);
+                if (current == nullptr || aligned + bytes > limit) {
+                    allocate_block(bytes + alignment);
+                    aligned = _detail::_align_up(cursor, alignment);
+                }
+                cursor = aligned + bytes;
+                bytes_used += bytes;
+                return reinterpret_cast<void *>(aligned);
+            }
+
+            //! Appends a block with at least the specified number of usable bytes, the following block will be twice as large
+            void allocate_block(std::size_t min_size) {
+                const std::size_t size = std::max(next_block_size, min_size);
+                auto *block = static_cast<_block_header *>(::operator new(_detail::_header_size<_block_header>() + size));
+                block->previous = current;
+                block->size = size;
+                current = block;
+                cursor = block_data(block);
+                limit = cursor + size;
+                bytes_reserved += size;
+                next_block_size = 2 * size;
+            }
+
+            static void free_blocks(_block_header *block) {
+                while (block != nullptr) {
+                    _block_header *previous = block->previous;
+                    ::operator delete(block);
+                    block = previous;
+                }
+            }
+
+#ifdef NONAME_HAS_MEMORY_RESOURCE
+            void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+                return allocate_bytes(bytes, alignment);
+            }
+
+            void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+                return this == &other;
+            }
+#endif
+
+            friend class pool_resource;
+
+            _block_header *current = nullptr;
+            std::uintptr_t cursor = 0;
+            std::uintptr_t limit = 0;
+            std::size_t next_block_size;
+            std::size_t bytes_used = 0;
+            std::size_t bytes_reserved = 0;
+        };
+
+        //! Memory resource which recycles deallocated memory in free lists of power of two size classes carved from a monotonic_arena, larger allocations are forwarded to operator new
+        /*
+         * Like the monotonic_arena, all memory is released at once by reset() once the objects allocated from the resource
+         * have been destroyed, but memory that is deallocated in between is reused for later allocations of the same size class.
+         */
+        class pool_resource
+#ifdef NONAME_HAS_MEMORY_RESOURCE
+                : public std::pmr::memory_resource
+#endif
+        {
+        public:
+            //! Largest allocation size in bytes that is served from the pools
+            static constexpr std::size_t max_pooled_size = 1024;
+
+            //! Creates an empty resource whose arena starts with a block of the specified size
+            explicit pool_resource(std::size_t initial_block_size = monotonic_arena::default_block_size)
+                    : arena(initial_block_size) {
+                free_lists.fill(nullptr);
+            }
+
+            pool_resource(const pool_resource &) = delete;
+
+            pool_resource &operator=(const pool_resource &) = delete;
+
+            ~pool_resource() {
+                release_large();
+            }
+
+#ifndef NONAME_HAS_MEMORY_RESOURCE
+            //! Returns memory of the specified size and power of two alignment
+            void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+                return allocate_bytes(bytes, alignment);
+            }
+
+            //! Returns memory to its pool or to the system if it was too large to be pooled
+            void deallocate(void *p, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+                deallocate_bytes(p, bytes, alignment);
+            }
+#endif
+
+            //! Releases all memory while keeping the largest block of the arena, invalidates all previous allocations
+            void reset() {
+                release_large();
+                arena.reset();
+                free_lists.fill(nullptr);
+            }
+
+            //! Returns the number of bytes taken from the arena or the system since the last reset
+            std::size_t bytes_allocated() const { return arena.bytes_allocated() + large_bytes; }
+
+        private:
+            struct _free_node {
+                _free_node *next;
+            };
+
+            struct _large_header {
+                _large_header *previous;
+                _large_header *next;
+                std::size_t size;
+            };
+
+            static constexpr std::size_t min_class_shift = 3;
+            static constexpr std::size_t n_classes = 8;
+
+            //! Returns the index of the smallest size class holding the specified number of bytes
+            static std::size_t size_class(std::size_t bytes) {
+                std::size_t c = 0;
+                while ((std::size_t(1) << (c + min_class_shift)) < bytes) ++c;
+                return c;
+            }
+
+            void *allocate_bytes(std::size_t bytes, std::size_t alignment) {
+                // Over-aligned memory is taken from the arena directly and only reclaimed by reset()
+                if (alignment > alignof(std::max_align_t)) return arena.allocate_bytes(bytes, alignment);
+
+                const std::size_t size = std::max(bytes, alignment);
+                if (size <= max_pooled_size) {
+                    const std::size_t c = size_class(size);
+                    if (free_lists[c] != nullptr) {
+                        _free_node *node = free_lists[c];
+                        free_lists[c] = node->next;
+                        return node;
+                    }
+                    const std::size_t class_size = std::size_t(1) << (c + min_class_shift);
+                    return arena.allocate_bytes(class_size, std::min(class_size, alignof(std::max_align_t)));
+                }
+
+                auto *header = static_cast<_large_header *>(::operator new(_detail::_header_size<_large_header>() + bytes));
+                header->previous = nullptr;
+                header->next = large_blocks;
+                header->size = bytes;
+                if (large_blocks != nullptr) large_blocks->previous = header;
+                large_blocks = header;
+                large_bytes += bytes;
+                return reinterpret_cast<char *>(header) + _detail::_header_size<_large_header>();
+            }
+
+            void deallocate_bytes(void *p, std::size_t bytes, std::size_t alignment) {
+                if (alignment > alignof(std::max_align_t)) return;
+
+                const std::size_t size = std::max(bytes, alignment);
+                if (size <= max_pooled_size) {
+                    const std::size_t c = size_class(size);
+                    auto *node = static_cast<_free_node *>(p);
+                    node->next = free_lists[c];
+                    free_lists[c] = node;
+                    return;
+                }
+
+                auto *header = reinterpret_cast<_large_header *>(static_cast<char *>(p) - _detail::_header_size<_large_header>());
+                if (header->previous != nullptr) header->previous->next = header->next;
+                else large_blocks = header->next;
+                if (header->next != nullptr) header->next->previous = header->previous;
+                large_bytes -= header->size;
+                ::operator delete(header);
+            }
+
+            void release_large() {
+                while (large_blocks != nullptr) {
+                    _large_header *next = large_blocks->next;
+                    ::operator delete(large_blocks);
+                    large_blocks = next;
+                }
+                large_bytes = 0;
+            }
+
+#ifdef NONAME_HAS_MEMORY_RESOURCE
+            void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+                return allocate_bytes(bytes, alignment);
+            }
+
+            void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+                deallocate_bytes(p, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+                return this == &other;
+            }
+#endif
+
+            monotonic_arena arena;
+            std::array<_free_node *, n_classes> free_lists;
+            _large_header *large_blocks = nullptr;
+            std::size_t large_bytes = 0;
+        };
+
+        //! Standard allocator which obtains its memory from a monotonic_arena, a pool_resource or any other type with the same allocate/deallocate interface
+        template<typename T, typename Resource = monotonic_arena>
+        class arena_allocator {
+        public:
+            using value_type = T;
+
+            //! Creates an allocator using the specified resource, which has to outlive all allocations
+            arena_allocator(Resource &resource) noexcept
+                    : memory(&resource) {}
+
+            template<typename U>
+            arena_allocator(const arena_allocator<U, Resource> &other) noexcept
+                    : memory(other.resource()) {}
+
+            T *allocate(std::size_t n) {
+                return static_cast<T *>(memory->allocate(n * sizeof(T), alignof(T)));
+            }
+
+            void deallocate(T *p, std::size_t n) {
+                memory->deallocate(p, n * sizeof(T), alignof(T));
+            }
+
+            //! Returns the resource used by the allocator
+            Resource *resource() const { return memory; }
+
+        private:
+            Resource *memory;
+        };
+
+        template<typename T, typename U, typename Resource>
+        bool operator==(const arena_allocator<T, Resource> &lhs, const arena_allocator<U, Resource> &rhs) {
+            return lhs.resource() == rhs.resource();
+        }
+
+        template<typename T, typename U, typename Resource>
+        bool operator!=(const arena_allocator<T, Resource> &lhs, const arena_allocator<U, Resource> &rhs) {
+            return !(lhs == rhs);
+        }
+    }
+}
@@ -0,0 +1,396 @@
+#pragma once
+
+//	MIT License
+//
+//	Copyright (c) 2020 Fabian Löschner
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include <cstddef>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+#include "general_defs.h"
+
+namespace noname {
+    namespace tools {
+        //! Assumed size of a cache line in bytes, data written by different threads should not share a cache line
+        NONAME_INLINE_VARIABLE constexpr std::size_t cache_line_size = 64;
+        //! Assumed size of a memory page in bytes
+        NONAME_INLINE_VARIABLE constexpr std::size_t page_size = 4096;
+
+        namespace _detail {
+            //! Bookkeeping of a single parallel_for call, tracks the outstanding tasks and the first exception thrown by any task
+            class _parallel_for_state {
+            public:
+                explicit _parallel_for_state(std::size_t pending)
+                        : pending(pending) {}
+
+                //! Calls the supplied function and stores the exception if it is the first one thrown
+                template<typename Func>
+                void invoke(Func &&f) noexcept {
+                    try {
+                        f();
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!exception) exception = std::current_exception();
+                    }
+                }
+
+                //! Marks one of the outstanding tasks as completed
+                void complete() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (--pending == 0) finished.notify_all();
+                }
+
+                //! Returns whether all tasks were completed
+                bool done() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    return pending == 0;
+                }
+
+                //! Blocks until all tasks were completed
+                void wait() {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    finished.wait(lock, [this]() { return pending == 0; });
+                }
+
+                //! Rethrows the first exception thrown by any task
+                void rethrow() {
+                    if (exception) std::rethrow_exception(exception);
+                }
+
+            private:
+                std::size_t pending;
+                std::exception_ptr exception;
+                std::mutex mutex;
+                std::condition_variable finished;
+            };
+        }
+
+        //! Fixed size pool of worker threads that executes the chunks of the parallel algorithms
+        /*
+         * The thread calling parallel_for always participates in the work and executes queued tasks while waiting.
+         * Therefore nested parallel_for calls from within a task cannot deadlock the pool.
+         */
+        class thread_pool {
+        public:
+            //! Starts the specified number of worker threads
+            explicit thread_pool(std::size_t n_workers) {
+                workers.reserve(n_workers);
+                for (std::size_t i = 0; i < n_workers; ++i) {
+                    workers.emplace_back([this]() { work(); });
+                }
+            }
+
+            thread_pool(const thread_pool &) = delete;
+
+            thread_pool &operator=(const thread_pool &) = delete;
+
+            //! Finishes all queued tasks and joins the worker threads
+            ~thread_pool() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                task_available.notify_all();
+                for (auto &worker : workers) worker.join();
+            }
+
+            //! Returns the number of threads executing a parallel_for call, i.e. the number of workers plus the calling thread
+            std::size_t concurrency() const {
+                return workers.size() + 1;
+            }
+
+            //! Calls f(i) for every i in [0, n) concurrently and blocks until all calls returned, rethrows the first exception thrown by any call
+            template<typename Func>
+            void parallel_for(std::size_t n, Func f) {
+                if (n == 0) return;
+                if (n == 1 || workers.empty()) {
+                    for (std::size_t i = 0; i < n; ++i) f(i);
+                    return;
+                }
+
+                _detail::_parallel_for_state state(n - 1);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (std::size_t i = 1; i < n; ++i) {
+                        tasks.emplace_back([&state, &f, i]() {
+                            state.invoke([&f, i]() { f(i); });
+                            state.complete();
+                        });
+                    }
+                }
+                task_available.notify_all();
+
+                state.invoke([&f]() { f(0); });
+                // Help with the queued tasks instead of blocking while they are pending
+                while (!state.done()) {
+                    if (!run_pending_task()) state.wait();
+                }
+                state.rethrow();
+            }
+
+        private:
+            //! Executes the oldest queued task on the calling thread, returns false if the queue was empty
+            bool run_pending_task() {
+                std::function<void()> task;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (tasks.empty()) return false;
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+                return true;
+            }
+
+            //! Main loop of the worker threads
+            void work() {
+                for (;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        task_available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+            std::vector<std::thread> workers;
+            std::deque<std::function<void()>> tasks;
+            std::mutex mutex;
+            std::condition_variable task_available;
+            bool stopping = false;
+        };
+
+        //! Returns the pool used by the parallel algorithms if no pool is specified, its concurrency equals the number of hardware threads
+        inline thread_pool &default_thread_pool() {
+            static thread_pool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+            return pool;
+        }
+
+        //! Exception thrown by the parallel algorithms if their cancellation_token was cancelled
+        class operation_cancelled : public std::exception {
+        public:
+            const char *what() const noexcept override {
+                return "The operation was cancelled.";
+            }
+        };
+
+        //! Flag to stop running parallel algorithms from another thread, the algorithms check it before every chunk and throw operation_cancelled once it is set
+        class cancellation_token {
+        public:
+            cancellation_token() = default;
+
+            cancellation_token(const cancellation_token &) = delete;
+
+            cancellation_token &operator=(const cancellation_token &) = delete;
+
+            //! Requests all algorithms using this token to stop, chunks that are already running are completed
+            void cancel() noexcept {
+                cancelled.store(true, std::memory_order_relaxed);
+            }
+
+            //! Returns whether cancel() was called since the construction or the last reset()
+            bool is_cancelled() const noexcept {
+                return cancelled.load(std::memory_order_relaxed);
+            }
+
+            //! Throws operation_cancelled if cancel() was called
+            void throw_if_cancelled() const {
+                if (is_cancelled()) throw operation_cancelled();
+            }
+
+            //! Clears the cancellation request so that the token can be used again
+            void reset() noexcept {
+                cancelled.store(false, std::memory_order_relaxed);
+            }
+
+        private:
+            std::atomic<bool> cancelled{false};
+        };
+
+        //! Receives the progress of the parallel algorithms, the callback is called with the number of completed chunks and the total number of chunks after every chunk of a parallel pass
+        /*
+         * Algorithms with several parallel passes (e.g. a histogram and a scatter pass) report every pass separately.
+         * The calls of the callback are serialized, so it does not have to be thread-safe itself.
+         */
+        class progress_monitor {
+        public:
+            explicit progress_monitor(std::function<void(std::size_t, std::size_t)> callback)
+                    : callback(std::move(callback)) {}
+
+            progress_monitor(const progress_monitor &) = delete;
+
+            progress_monitor &operator=(const progress_monitor &) = delete;
+
+            //! Calls the callback with the supplied progress
+            void report(std::size_t completed, std::size_t total) {
+                std::lock_guard<std::mutex> lock(mutex);
+                callback(completed, total);
+            }
+
+            //! Increments the completed count of a pass and reports it, the count is guarded by the same lock so concurrent chunks report increasing counts
+            void advance(std::size_t &completed, std::size_t total) {
+                std::lock_guard<std::mutex> lock(mutex);
+                callback(++completed, total);
+            }
+
+        private:
+            std::function<void(std::size_t, std::size_t)> callback;
+            std::mutex mutex;
+        };
+
+        //! Selects the parallel overload of an algorithm, optionally specifies the thread pool, the number of chunks the input is divided into, a cancellation token and a progress monitor
+        struct parallel_policy {
+            explicit constexpr parallel_policy(thread_pool *pool = nullptr, std::size_t n_chunks = 0, cancellation_token *cancellation = nullptr,
+                                               progress_monitor *progress = nullptr)
+                    : pool(pool), n_chunks(n_chunks), cancellation(cancellation), progress(progress) {}
+
+            //! Returns the pool executing the chunks
+            thread_pool &executor() const {
+                return (pool != nullptr) ? *pool : default_thread_pool();
+            }
+
+            //! Returns the number of chunks the input should be divided into
+            std::size_t chunk_count() const {
+                return (n_chunks != 0) ? n_chunks : executor().concurrency();
+            }
+
+            //! Calls f(i) for every i in [0, n) on the executor, checks the cancellation token before and reports the progress after every call
+            template<typename Func>
+            void parallel_for(std::size_t n, Func f) const {
+                if (cancellation == nullptr && progress == nullptr) {
+                    executor().parallel_for(n, f);
+                    return;
+                }
+
+                std::size_t completed = 0;
+                executor().parallel_for(n, [this, &f, &completed, n](std::size_t i) {
+                    if (cancellation != nullptr) cancellation->throw_if_cancelled();
+                    f(i);
+                    if (progress != nullptr) progress->advance(completed, n);
+                });
+            }
+
+            //! The pool used to execute the chunks, uses the default_thread_pool() if nullptr
+            thread_pool *pool;
+            //! The number of chunks, uses the concurrency of the pool if zero
+            std::size_t n_chunks;
+            //! Token checked before every chunk, no cancellation if nullptr
+            cancellation_token *cancellation;
+            //! Monitor notified after every chunk, no progress reporting if nullptr
+            progress_monitor *progress;
+        };
+
+        //! Parallel policy using the default thread pool with one chunk per thread
+        NONAME_INLINE_VARIABLE constexpr parallel_policy par{};
+
+        //! Output sink with one buffer per shard, e.g. per chunk of a parallel algorithm, which are concatenated at the end
+        /*
+         * Every shard may be written by a different thread without any synchronization as long as no shard is used by two
+         * threads at the same time. Writing the result of chunk k to shard k and merging in shard order makes the output
+         * independent of the thread scheduling.
+         */
+        template<typename T>
+        class sharded_sink {
+        public:
+            using value_type = T;
+
+            //! Creates a sink with the specified number of empty shards
+            explicit sharded_sink(std::size_t n_shards)
+                    : shards(n_shards) {}
+
+            //! Returns the number of shards
+            std::size_t shard_count() const { return shards.size(); }
+
+            //! Returns an output iterator appending to the buffer of shard i
+            std::back_insert_iterator<std::vector<T>> shard(std::size_t i) {
+                return std::back_inserter(shards[i].values);
+            }
+
+            //! Returns the buffer of shard i
+            std::vector<T> &buffer(std::size_t i) { return shards[i].values; }
+
+            //! Returns the total number of values in all shards
+            std::size_t size() const {
+                std::size_t n = 0;
+                for (const auto &shard : shards) n += shard.values.size();
+                return n;
+            }
+
+            //! Moves the values of all shards in shard order to dest and empties the shards
+            template<typename OutputIt>
+            OutputIt merge(OutputIt dest) {
+                for (auto &shard : shards) {
+                    dest = std::move(shard.values.begin(), shard.values.end(), dest);
+                    shard.values.clear();
+                }
+                return dest;
+            }
+
+            //! Returns the values of all shards in shard order and empties the shards
+            std::vector<T> merge() {
+                std::vector<T> values;
+                values.reserve(size());
+                merge(std::back_inserter(values));
+                return values;
+            }
+
+            //! Returns the values of all shards in unspecified order, reuses the largest buffer to avoid moving its values
+            std::vector<T> merge_unordered() {
+                if (shards.empty()) return {};
+                auto largest = std::max_element(shards.begin(), shards.end(),
+                                                [](const _shard &a, const _shard &b) { return a.values.size() < b.values.size(); });
+                std::vector<T> values = std::move(largest->values);
+                largest->values.clear();
+                values.reserve(values.size() + size());
+                merge(std::back_inserter(values));
+                return values;
+            }
+
+            //! Empties all shards
+            void clear() {
+                for (auto &shard : shards) shard.values.clear();
+            }
+
+        private:
+            //! Buffer of a shard, the padding keeps the buffers of neighboring shards on different cache lines
+            struct _shard {
+                std::vector<T> values;
+                char padding[cache_line_size];
+            };
+
+            std::vector<_shard> shards;
+        };
+    }
+}
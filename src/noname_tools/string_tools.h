@@ -25,6 +25,8 @@
 #include <string>
 #include <vector>
 
+#include "memory_tools.h"
+
 namespace noname {
     namespace tools {
         //! Truncates a string at the first occurrence of the specified character or returns the full string if the character was not found
@@ -50,5 +52,25 @@ namespace noname {
             strings.emplace_back(str.substr(start, size - start));
             return strings;
         }
+
+        //! Returns a vector of substrings of the original string, split at every occurrence of the specified character, the vector and the substrings obtain their memory from the supplied allocator
+        template<typename StringT, typename CharT, typename Allocator>
+        alloc_vector_t<alloc_string_t<Allocator, typename StringT::value_type, typename StringT::traits_type>, Allocator>
+        split_string(const StringT &str, CharT ch, const Allocator &alloc) {
+            using string_t = alloc_string_t<Allocator, typename StringT::value_type, typename StringT::traits_type>;
+            const rebind_alloc_t<Allocator, typename StringT::value_type> char_alloc(alloc);
+            alloc_vector_t<string_t, Allocator> strings(alloc);
+            const auto size = str.size();
+            auto start = decltype(size)(0);
+            auto count = str.find_first_of(ch);
+            while (count != std::string::npos) {
+                count -= start;
+                strings.emplace_back(string_t(str.data() + start, count, char_alloc));
+                start += count + 1;
+                count = str.find_first_of(ch, start);
+            }
+            strings.emplace_back(string_t(str.data() + start, size - start, char_alloc));
+            return strings;
+        }
     }
 }
@@ -26,6 +26,8 @@
 #include <initializer_list>
 #include <algorithm>
 
+#include "container_tools.h"
+#include "memory_tools.h"
 #include "typetraits_tools.h"
 #include "utility_tools.h"
 
@@ -39,35 +41,34 @@ namespace noname {
             return vector;
         }
 
-        //! Sorts the supplied r-value vector and returns it
-        template<typename T>
-        std::vector<T> sorted_vector(std::vector<T> &&vector) {
+        //! Returns a sorted vector constructed from the supplied initializer list which obtains its memory from the supplied allocator
+        template<typename T, typename Allocator>
+        alloc_vector_t<T, Allocator> sorted_vector(std::initializer_list<T> in, const Allocator &alloc) {
+            alloc_vector_t<T, Allocator> vector(in, alloc);
             std::sort(vector.begin(), vector.end());
             return vector;
         }
 
-        namespace _detail {
-            template<typename VecT, typename T, typename... Ts>
-            struct move_construct_helper;
-
-            template<typename VecT, typename T>
-            struct move_construct_helper<VecT, T> {
-                move_construct_helper(VecT &vector, T &&element) {
-                    vector.emplace_back(std::move(element));
-                }
-            };
+        //! Sorts the supplied r-value vector and returns it
+        template<typename T, typename Allocator>
+        std::vector<T, Allocator> sorted_vector(std::vector<T, Allocator> &&vector) {
+            std::sort(vector.begin(), vector.end());
+            return vector;
+        }
 
-            template<typename VecT, typename T, typename... Ts>
-            struct move_construct_helper {
-                move_construct_helper(VecT &vector, T &&element, Ts &&... remaining) {
-                    vector.emplace_back(std::move(element));
-                    move_construct_helper<VecT, Ts...> temp(vector, std::forward<Ts>(remaining)...);
-                }
-            };
+        //! Sorts the supplied r-value vector using comp and returns it
+        template<typename T, typename Allocator, typename Compare>
+        std::vector<T, Allocator> sorted_vector(std::vector<T, Allocator> &&vector, Compare comp) {
+            std::sort(vector.begin(), vector.end(), comp);
+            return vector;
+        }
 
+        namespace _detail {
+            //! Moves all elements into the vector in order using a single pack expansion
             template<typename VecT, typename... Ts>
             void move_construct_helper_fun(VecT &vector, Ts &&... elements) {
-                move_construct_helper<VecT, Ts...> temp(vector, std::forward<Ts>(elements)...);
+                using expander = int[];
+                (void) expander{0, (vector.emplace_back(std::move(elements)), 0)...};
             }
         }
 
@@ -78,8 +79,36 @@ namespace noname {
                           "All supplied elements have to be of the same type.");
             std::vector<nth_element_t<0, Ts...>> vector;
             vector.reserve(sizeof...(elements));
-            move_construct_helper_fun(vector, std::forward<Ts>(elements)...);
+            _detail::move_construct_helper_fun(vector, std::forward<Ts>(elements)...);
+            return vector;
+        }
+
+        //! Initializes a vector which obtains its memory from the supplied allocator by moving all supplied elements into it
+        template<typename Allocator, typename... Ts>
+        alloc_vector_t<nth_element_t<0, Ts...>, Allocator> move_construct_vector(std::allocator_arg_t, const Allocator &alloc, Ts &&... elements) {
+            static_assert(conjunction<std::is_same<Ts, nth_element_t<0, Ts...>>...>::value,
+                          "All supplied elements have to be of the same type.");
+            alloc_vector_t<nth_element_t<0, Ts...>, Allocator> vector(alloc);
+            vector.reserve(sizeof...(elements));
+            _detail::move_construct_helper_fun(vector, std::forward<Ts>(elements)...);
             return vector;
         }
+
+        //! Initializes a small_vector with inline capacity N by moving all supplied elements into it
+        template<std::size_t N, typename... Ts>
+        small_vector<nth_element_t<0, Ts...>, N> move_construct_small_vector(Ts &&... elements) {
+            static_assert(conjunction<std::is_same<Ts, nth_element_t<0, Ts...>>...>::value,
+                          "All supplied elements have to be of the same type.");
+            small_vector<nth_element_t<0, Ts...>, N> vector;
+            vector.reserve(sizeof...(elements));
+            _detail::move_construct_helper_fun(vector, std::forward<Ts>(elements)...);
+            return vector;
+        }
+
+        //! Initializes a small_vector with an inline capacity of exactly the number of supplied elements by moving them into it
+        template<typename... Ts>
+        small_vector<nth_element_t<0, Ts...>, sizeof...(Ts)> move_construct_small_vector(Ts &&... elements) {
+            return move_construct_small_vector<sizeof...(Ts)>(std::forward<Ts>(elements)...);
+        }
     }
 }
@@ -21,6 +21,7 @@
 //	SOFTWARE.
 
 #include <noname_tools/algorithm_tools.h>
+#include <noname_tools/vector_tools.h>
 
 #include "catch2/catch.hpp"
 
@@ -30,6 +31,18 @@
 #include <functional>
 #include <type_traits>
 #include <algorithm>
+#include <cstdint>
+#include <random>
+#include <limits>
+#include <string>
+#include <cctype>
+#include <cstring>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <list>
+#include <atomic>
+#include <stdexcept>
 
 using namespace noname;
 
@@ -133,6 +146,148 @@ TEST_CASE("Testing n_subranges") {
     }
 }
 
+TEST_CASE("Testing n_subranges_weighted") {
+    // Type used for source vector
+    typedef std::size_t value_t;
+    // Source vector, the value of every element is used as its weight
+    std::vector<value_t> source;
+    // Vector of output of n_subranges_weighted
+    std::vector<decltype(source)::iterator> ranges;
+    // Weight function
+    const auto weight = [](const value_t &v) { return v; };
+
+    SECTION("Single heavy element gets its own subrange") {
+        source = {1, 1, 1, 1, 1, 1, 1, 1, 1, 10};
+
+        tools::n_subranges_weighted(source.begin(), source.end(), std::back_inserter(ranges), 2, weight);
+
+        REQUIRE(ranges.size() == 3);
+        REQUIRE(ranges[0] == source.begin());
+        REQUIRE(ranges[1] == source.begin() + 9);
+        REQUIRE(ranges[2] == source.end());
+    }
+
+    SECTION("Equal weights give the same subranges as n_subranges") {
+        source.assign(12, 3);
+        std::vector<decltype(source)::iterator> unweighted;
+
+        tools::n_subranges_weighted(source.begin(), source.end(), std::back_inserter(ranges), 4, weight);
+        tools::n_subranges(source.begin(), source.end(), std::back_inserter(unweighted), 4);
+
+        REQUIRE(ranges == unweighted);
+    }
+
+    SECTION("Precomputed prefix sums") {
+        source = {4, 1, 1, 1, 1, 4};
+        const std::vector<double> cumulative = {4, 5, 6, 7, 8, 12};
+
+        tools::n_subranges_weighted_cumulative(source.begin(), source.end(), std::back_inserter(ranges), 3, cumulative.begin());
+
+        REQUIRE(ranges.size() == 4);
+        REQUIRE(ranges[1] == source.begin() + 1);
+        REQUIRE(ranges[2] == source.begin() + 5);
+
+        std::vector<decltype(source)::iterator> from_pointer;
+        tools::n_subranges_weighted_cumulative(source.begin(), source.end(), std::back_inserter(from_pointer), 3, cumulative.data());
+        REQUIRE(from_pointer == ranges);
+    }
+
+    SECTION("Function pointer as weight") {
+        source = {1, 1, 1, 1, 1, 1, 1, 1, 1, 10};
+        value_t (*const weight_pointer)(const value_t &) = [](const value_t &v) { return v; };
+
+        tools::n_subranges_weighted(source.begin(), source.end(), std::back_inserter(ranges), 2, weight_pointer);
+
+        REQUIRE(ranges.size() == 3);
+        REQUIRE(ranges[1] == source.begin() + 9);
+    }
+
+    SECTION("Subranges are never empty") {
+        source = {100, 0, 0, 0, 0};
+
+        tools::n_subranges_weighted(source.begin(), source.end(), std::back_inserter(ranges), 10, weight);
+
+        REQUIRE(ranges.size() == 6);
+        for (std::size_t i = 0; i + 1 < ranges.size(); ++i) {
+            REQUIRE(ranges[i] < ranges[i + 1]);
+        }
+    }
+
+    SECTION("Zero total weight and empty input") {
+        source.assign(6, 0);
+        tools::n_subranges_weighted(source.begin(), source.end(), std::back_inserter(ranges), 3, weight);
+        REQUIRE(ranges.size() == 4);
+        REQUIRE(ranges[1] == source.begin() + 2);
+
+        ranges.clear();
+        source.clear();
+        tools::n_subranges_weighted(source.begin(), source.end(), std::back_inserter(ranges), 3, weight);
+        REQUIRE(ranges.empty());
+    }
+}
+
+TEST_CASE("Testing n_subranges_aligned") {
+    // Aligned source buffer
+    alignas(64) static int source[1000];
+    // Vector of output of n_subranges_aligned
+    std::vector<int *> ranges;
+    // Checks whether a pointer is aligned to the specified number of bytes
+    const auto is_aligned = [](const void *ptr, std::size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+    };
+
+    SECTION("Boundaries are rounded to cache lines") {
+        tools::n_subranges_aligned(std::begin(source), std::end(source), std::back_inserter(ranges), 4);
+
+        REQUIRE(ranges.size() == 5);
+        REQUIRE(ranges.front() == std::begin(source));
+        REQUIRE(ranges.back() == std::end(source));
+        REQUIRE(ranges[1] == source + 256);
+        REQUIRE(ranges[2] == source + 496);
+        REQUIRE(ranges[3] == source + 752);
+    }
+
+    SECTION("Unaligned first element") {
+        tools::n_subranges_aligned(source + 3, std::end(source), std::back_inserter(ranges), 5, 32);
+
+        REQUIRE(ranges.size() == 6);
+        REQUIRE(ranges.front() == source + 3);
+        REQUIRE(ranges.back() == std::end(source));
+        for (std::size_t i = 1; i + 1 < ranges.size(); ++i) {
+            REQUIRE(is_aligned(ranges[i], 32));
+            REQUIRE(ranges[i - 1] < ranges[i]);
+        }
+    }
+
+    SECTION("Range with fewer aligned elements than subranges") {
+        tools::n_subranges_aligned(source, source + 20, std::back_inserter(ranges), 4);
+
+        REQUIRE(ranges.size() == 3);
+        REQUIRE(ranges[1] == source + 16);
+        REQUIRE(ranges[2] == source + 20);
+    }
+
+    SECTION("Element size not dividing the alignment") {
+        alignas(64) static std::array<char, 12> records[100];
+        std::vector<std::array<char, 12> *> record_ranges;
+
+        tools::n_subranges_aligned(std::begin(records), std::end(records), std::back_inserter(record_ranges), 3);
+
+        REQUIRE(record_ranges.size() == 4);
+        for (std::size_t i = 1; i + 1 < record_ranges.size(); ++i) {
+            REQUIRE(is_aligned(record_ranges[i], 64));
+        }
+    }
+
+    SECTION("Empty input range and n = 0") {
+        tools::n_subranges_aligned(source, source, std::back_inserter(ranges), 4);
+        REQUIRE(ranges.empty());
+
+        tools::n_subranges_aligned(std::begin(source), std::end(source), std::back_inserter(ranges), 0);
+        REQUIRE(ranges.empty());
+    }
+}
+
 TEST_CASE("Testing for_each_and_successor") {
     // Value type for the test container
     typedef std::size_t value_t;
@@ -187,6 +342,175 @@ TEST_CASE("Testing for_each_and_successor") {
     }
 }
 
+TEST_CASE("Testing parallel for_each_and_successor") {
+    // Value type for the test container
+    typedef std::size_t value_t;
+
+    // Pool with a few workers, chunk count larger than the concurrency
+    tools::thread_pool pool(3);
+    const tools::parallel_policy policy(&pool, 7);
+
+    // Functor collecting all visited pairs
+    struct collector {
+        void operator()(const value_t &a, const value_t &b) {
+            pairs.emplace_back(a, b);
+        }
+
+        std::vector<std::pair<value_t, value_t>> pairs;
+    };
+    const auto concat = [](collector lhs, collector rhs) {
+        lhs.pairs.insert(lhs.pairs.end(), rhs.pairs.begin(), rhs.pairs.end());
+        return lhs;
+    };
+
+    SECTION("Every pair is visited exactly once in order") {
+        std::vector<value_t> source(1000);
+        std::iota(source.begin(), source.end(), 0);
+
+        const auto serial = tools::for_each_and_successor(source.begin(), source.end(), collector{});
+        const auto parallel = tools::for_each_and_successor(policy, source.begin(), source.end(), collector{}, concat);
+
+        REQUIRE(parallel.pairs.size() == source.size() - 1);
+        REQUIRE(parallel.pairs == serial.pairs);
+    }
+
+    SECTION("Deltas written without reduction") {
+        std::vector<int> source(500);
+        std::iota(source.begin(), source.end(), 0);
+        std::transform(source.begin(), source.end(), source.begin(), [](int i) { return i * i; });
+        std::vector<int> deltas(source.size() - 1);
+
+        tools::for_each_and_successor(policy, source.begin(), source.end(), [&](const int &a, const int &b) {
+            deltas[&a - source.data()] = b - a;
+        });
+
+        for (std::size_t i = 0; i < deltas.size(); ++i) {
+            REQUIRE(deltas[i] == static_cast<int>(2 * i + 1));
+        }
+    }
+
+    SECTION("Fewer pairs than chunks") {
+        const std::vector<value_t> source = {1, 2, 3};
+
+        const auto result = tools::for_each_and_successor(policy, source.begin(), source.end(), collector{}, concat);
+
+        REQUIRE(result.pairs.size() == 2);
+        REQUIRE(result.pairs.back() == std::make_pair(value_t(2), value_t(3)));
+    }
+
+    SECTION("Empty input range and one element") {
+        std::vector<value_t> source;
+        auto result = tools::for_each_and_successor(policy, source.begin(), source.end(), collector{}, concat);
+        REQUIRE(result.pairs.empty());
+
+        source = {42};
+        result = tools::for_each_and_successor(tools::par, source.begin(), source.end(), collector{}, concat);
+        REQUIRE(result.pairs.empty());
+    }
+}
+
+TEST_CASE("Testing for_each_window") {
+    SECTION("Compile-time width") {
+        const std::list<int> values = {1, 2, 4, 7, 11};
+        std::vector<int> sums;
+        tools::for_each_window<3>(values.begin(), values.end(), [&sums](int a, int b, int c) { sums.push_back(a + b + c); });
+        REQUIRE(sums == std::vector<int>({7, 13, 22}));
+
+        std::vector<int> deltas;
+        tools::for_each_window<2>(values.begin(), values.end(), [&deltas](int a, int b) { deltas.push_back(b - a); });
+        REQUIRE(deltas == std::vector<int>({1, 2, 3, 4}));
+
+        std::vector<int> singles;
+        tools::for_each_window<1>(values.begin(), values.end(), [&singles](int a) { singles.push_back(a); });
+        REQUIRE(singles == std::vector<int>(values.begin(), values.end()));
+
+        int calls = 0;
+        tools::for_each_window<6>(values.begin(), values.end(), [&calls](int, int, int, int, int, int) { ++calls; });
+        REQUIRE(calls == 0);
+
+        std::vector<int> mutable_values = {1, 2, 3};
+        tools::for_each_window<2>(mutable_values.begin(), mutable_values.end(), [](int &a, int &b) { b += a; });
+        REQUIRE(mutable_values == std::vector<int>({1, 3, 6}));
+    }
+
+    SECTION("Runtime width") {
+        const std::vector<int> values = {3, 1, 4, 1, 5, 9, 2, 6};
+        for (std::size_t w = 0; w <= values.size() + 1; ++w) {
+            std::vector<int> sums;
+            tools::for_each_window(values.begin(), values.end(), w, [&sums, w](const auto &window) {
+                REQUIRE(window.size() == w);
+                sums.push_back(std::accumulate(window.begin(), window.end(), 0));
+            });
+
+            std::vector<int> expected;
+            for (std::size_t i = 0; w > 0 && i + w <= values.size(); ++i) {
+                expected.push_back(std::accumulate(values.begin() + i, values.begin() + i + w, 0));
+            }
+            REQUIRE(sums == expected);
+        }
+    }
+}
+
+TEST_CASE("Testing sliding window aggregates") {
+    std::mt19937 gen(48);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    std::vector<int> values(2000);
+    for (auto &x : values) x = dist(gen);
+
+    SECTION("Maximum and minimum") {
+        for (std::size_t w : {1, 2, 7, 100, 3000}) {
+            tools::sliding_window_max<int> max(w);
+            tools::sliding_window_max<int, std::greater<>> min(w);
+            REQUIRE(max.width() == w);
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                max.push(values[i]);
+                min.push(values[i]);
+
+                const auto window_first = values.begin() + static_cast<std::ptrdiff_t>(i + 1 - std::min(i + 1, w));
+                const auto window_last = values.begin() + static_cast<std::ptrdiff_t>(i + 1);
+                REQUIRE(max.size() == static_cast<std::size_t>(window_last - window_first));
+                REQUIRE(max.value() == *std::max_element(window_first, window_last));
+                REQUIRE(min.value() == *std::min_element(window_first, window_last));
+            }
+        }
+
+        tools::sliding_window_max<std::string> last_word(2);
+        last_word.push("b");
+        last_word.push("a");
+        REQUIRE(last_word.value() == "b");
+        last_word.push("a");
+        REQUIRE(last_word.value() == "a");
+        last_word.clear();
+        REQUIRE(last_word.size() == 0);
+    }
+
+    SECTION("Sums") {
+        for (std::size_t w : {1, 3, 50, 3000}) {
+            tools::sliding_window_sum<long> sum(w);
+            tools::sliding_window_sum<double> real_sum(w);
+            REQUIRE(sum.width() == w);
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                sum.push(values[i]);
+                real_sum.push(values[i] * 0.1);
+
+                const auto window_first = values.begin() + static_cast<std::ptrdiff_t>(i + 1 - std::min(i + 1, w));
+                const auto window_last = values.begin() + static_cast<std::ptrdiff_t>(i + 1);
+                const long expected = std::accumulate(window_first, window_last, 0L);
+                REQUIRE(sum.size() == static_cast<std::size_t>(window_last - window_first));
+                REQUIRE(sum.value() == expected);
+                REQUIRE(std::abs(real_sum.value() - expected * 0.1) < 1e-9);
+            }
+        }
+
+        tools::sliding_window_sum<int> sum(2);
+        sum.push(5);
+        sum.clear();
+        sum.push(1);
+        REQUIRE(sum.value() == 1);
+        REQUIRE(sum.size() == 1);
+    }
+}
+
 TEST_CASE("Testing find_unequal_successor") {
     // Value type for source container
     typedef std::size_t value_t;
@@ -264,6 +588,744 @@ TEST_CASE("Testing find_unequal_successor") {
     }
 }
 
+TEST_CASE("Testing parallel find_unequal_successor") {
+    tools::thread_pool pool(3);
+
+    for (std::size_t n_chunks : {1, 2, 7, 64}) {
+        const tools::parallel_policy policy(&pool, n_chunks);
+        for (std::size_t position : {1, 2, 500, 4999, 5000}) {
+            std::vector<int> values(5000, 3);
+            std::fill(values.begin() + static_cast<std::ptrdiff_t>(std::min<std::size_t>(position, values.size())), values.end(), 4);
+            if (position + 10 < values.size()) values[position + 10] = 5;
+
+            REQUIRE(tools::find_unequal_successor(policy, values.begin(), values.end())
+                    == tools::find_unequal_successor(values.begin(), values.end()));
+            REQUIRE(tools::find_unequal_successor(policy, values.begin(), values.end(), [](int a, int b) { return b - a > 0; })
+                    == tools::find_unequal_successor(values.begin(), values.end(), [](int a, int b) { return b - a > 0; }));
+        }
+    }
+
+    const std::list<int> constant = {1, 1, 1};
+    REQUIRE(tools::find_unequal_successor(tools::parallel_policy(&pool), constant.begin(), constant.end()) == constant.end());
+    const std::vector<int> empty;
+    REQUIRE(tools::find_unequal_successor(tools::parallel_policy(&pool), empty.begin(), empty.end()) == empty.end());
+
+    tools::cancellation_token token;
+    token.cancel();
+    const std::vector<int> values = {1, 2};
+    REQUIRE_THROWS_AS(tools::find_unequal_successor(tools::parallel_policy(&pool, 0, &token), values.begin(), values.end()), tools::operation_cancelled);
+
+    // A running chunk also stops once the token is cancelled
+    token.reset();
+    const std::vector<int> constant_values(100000, 1);
+    std::size_t calls = 0;
+    REQUIRE_THROWS_AS(tools::find_unequal_successor(tools::parallel_policy(&pool, 1, &token), constant_values.begin(), constant_values.end(),
+                                                    [&](int a, int b) {
+                                                        if (++calls == 10) token.cancel();
+                                                        return a != b;
+                                                    }), tools::operation_cancelled);
+    REQUIRE(calls < constant_values.size() - 1);
+}
+
+TEST_CASE("Testing parallel strict_unique_copy") {
+    tools::thread_pool pool(3);
+    std::mt19937 gen(41);
+    std::uniform_int_distribution<int> dist(0, 3);
+
+    for (std::size_t n_chunks : {1, 2, 7, 64}) {
+        std::vector<int> input(300);
+        for (auto &x : input) x = dist(gen);
+
+        std::vector<int> expected;
+        tools::strict_unique_copy(input.begin(), input.end(), std::back_inserter(expected));
+
+        std::vector<int> result;
+        tools::strict_unique_copy(tools::parallel_policy(&pool, n_chunks), input.begin(), input.end(), std::back_inserter(result));
+        REQUIRE(result == expected);
+
+        std::vector<int> result_pred;
+        tools::strict_unique_copy(tools::parallel_policy(&pool, n_chunks), input.begin(), input.end(), std::back_inserter(result_pred),
+                                  [](int a, int b) { return (a < 2) == (b < 2); });
+        std::vector<int> expected_pred;
+        tools::strict_unique_copy(input.begin(), input.end(), std::back_inserter(expected_pred),
+                                  [](int a, int b) { return (a < 2) == (b < 2); });
+        REQUIRE(result_pred == expected_pred);
+    }
+
+    std::vector<int> empty, result;
+    tools::strict_unique_copy(tools::par, empty.begin(), empty.end(), std::back_inserter(result));
+    REQUIRE(result.empty());
+}
+
+TEST_CASE("Testing strict_unique_unordered") {
+    tools::thread_pool pool(3);
+    std::mt19937 gen(44);
+
+    for (int max_value : {3, 1000, 100000}) {
+        std::uniform_int_distribution<int> dist(0, max_value);
+        std::vector<int> input(5000);
+        for (auto &x : input) x = dist(gen);
+
+        // Reference: count with a sorted copy and keep the input order
+        std::vector<int> sorted = input;
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<int> expected;
+        for (int x : input) {
+            const auto range = std::equal_range(sorted.begin(), sorted.end(), x);
+            if (range.second - range.first == 1) expected.push_back(x);
+        }
+
+        std::vector<int> result;
+        tools::strict_unique_unordered(input.begin(), input.end(), std::back_inserter(result));
+        REQUIRE(result == expected);
+
+        for (std::size_t n_chunks : {1, 3, 8}) {
+            result.clear();
+            tools::strict_unique_unordered(tools::parallel_policy(&pool, n_chunks), input.begin(), input.end(), std::back_inserter(result));
+            REQUIRE(result == expected);
+        }
+    }
+
+    SECTION("Custom hash and equality") {
+        const std::vector<std::string> input = {"Apple", "pear", "APPLE", "Plum", "kiwi", "PEAR"};
+        const auto lower = [](std::string s) {
+            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return s;
+        };
+        const auto hash = [&](const std::string &s) { return std::hash<std::string>()(lower(s)); };
+        const auto eq = [&](const std::string &a, const std::string &b) { return lower(a) == lower(b); };
+
+        std::vector<std::string> result;
+        tools::strict_unique_unordered(tools::parallel_policy(&pool, 4), input.begin(), input.end(), std::back_inserter(result), hash, eq);
+        REQUIRE(result == std::vector<std::string>({"Plum", "kiwi"}));
+
+        std::vector<int> empty;
+        std::vector<int> empty_result;
+        tools::strict_unique_unordered(tools::par, empty.begin(), empty.end(), std::back_inserter(empty_result));
+        REQUIRE(empty_result.empty());
+    }
+}
+
+TEST_CASE("Testing runs") {
+    SECTION("Runs of a sorted vector") {
+        const std::vector<int> source = {1, 1, 1, 2, 3, 3};
+        std::vector<std::pair<int, std::size_t>> result;
+
+        for (const auto &run : tools::runs(source.begin(), source.end())) {
+            result.emplace_back(*run.begin(), run.size());
+        }
+
+        REQUIRE(result == std::vector<std::pair<int, std::size_t>>({{1, 3}, {2, 1}, {3, 2}}));
+    }
+
+    SECTION("Runs using a predicate") {
+        const std::vector<int> source = {1, 3, 2, 4, 6, 5};
+        const auto same_parity = [](int a, int b) { return a % 2 == b % 2; };
+
+        const auto range = tools::runs(source.begin(), source.end(), same_parity);
+
+        REQUIRE(range.size() == 3);
+        REQUIRE((*std::next(range.begin())).size() == 3);
+    }
+
+    SECTION("Empty input range") {
+        const std::vector<int> source;
+        const auto range = tools::runs(source.begin(), source.end());
+
+        REQUIRE(range.begin() == range.end());
+    }
+}
+
+TEST_CASE("Testing run_length_encode and run_length_decode") {
+    std::vector<int> values;
+    std::vector<std::size_t> counts;
+
+    SECTION("Encode and decode a sorted vector") {
+        std::vector<long> source;
+        for (long i = 0; i < 50; ++i) source.insert(source.end(), static_cast<std::size_t>(i % 7 + 1), i);
+
+        tools::run_length_encode(source.begin(), source.end(), std::back_inserter(values), std::back_inserter(counts));
+
+        REQUIRE(values.size() == 50);
+        REQUIRE(counts.size() == 50);
+        REQUIRE(counts[3] == 4);
+        REQUIRE(values[3] == 3);
+
+        std::vector<long> decoded;
+        tools::run_length_decode(values.begin(), values.end(), counts.begin(), std::back_inserter(decoded));
+        REQUIRE(decoded == source);
+    }
+
+    SECTION("Encode using a predicate") {
+        const std::vector<int> source = {1, 2, 11, 12, 13, 4};
+        const auto same_tens = [](int a, int b) { return a / 10 == b / 10; };
+
+        tools::run_length_encode(source.begin(), source.end(), std::back_inserter(values), std::back_inserter(counts), same_tens);
+
+        REQUIRE(values == std::vector<int>({1, 11, 4}));
+        REQUIRE(counts == std::vector<std::size_t>({2, 3, 1}));
+    }
+
+    SECTION("Parallel encode and decode match the serial versions") {
+        tools::thread_pool pool(3);
+        const tools::parallel_policy policy(&pool, 8);
+
+        std::vector<int> source;
+        for (int i = 0; i < 300; ++i) source.insert(source.end(), static_cast<std::size_t>((i * 37) % 11 + 1), i / 3);
+
+        std::vector<int> serial_values;
+        std::vector<std::size_t> serial_counts;
+        tools::run_length_encode(source.begin(), source.end(), std::back_inserter(serial_values), std::back_inserter(serial_counts));
+        tools::run_length_encode(policy, source.begin(), source.end(), std::back_inserter(values), std::back_inserter(counts));
+
+        REQUIRE(values == serial_values);
+        REQUIRE(counts == serial_counts);
+        REQUIRE(values.size() == 100);
+
+        std::vector<int> decoded(source.size());
+        const auto decoded_end = tools::run_length_decode(policy, values.begin(), values.end(), counts.begin(), decoded.begin());
+        REQUIRE(decoded_end == decoded.end());
+        REQUIRE(decoded == source);
+    }
+
+    SECTION("Empty input range") {
+        const std::vector<int> source;
+
+        tools::run_length_encode(source.begin(), source.end(), std::back_inserter(values), std::back_inserter(counts));
+        tools::run_length_encode(tools::par, source.begin(), source.end(), std::back_inserter(values), std::back_inserter(counts));
+
+        REQUIRE(values.empty());
+        REQUIRE(counts.empty());
+    }
+}
+
+TEST_CASE("Testing radix_sort") {
+    std::mt19937_64 rng(42);
+    tools::thread_pool pool(3);
+    const tools::parallel_policy policy(&pool, 5);
+
+    // Sorts random values with radix_sort and its parallel version, compares to std::sort
+    const auto check = [&](auto value_sample) {
+        using value_t = decltype(value_sample);
+        std::vector<value_t> source(5000);
+        std::uniform_int_distribution<int> distribution(-1000, 1000);
+        for (auto &v : source) v = static_cast<value_t>(distribution(rng)) * value_sample;
+
+        auto expected = source;
+        std::sort(expected.begin(), expected.end());
+
+        auto serial = source;
+        tools::radix_sort(serial.begin(), serial.end());
+        auto parallel = source;
+        tools::radix_sort(policy, parallel.begin(), parallel.end());
+
+        return serial == expected && parallel == expected;
+    };
+
+    SECTION("Integral types") {
+        REQUIRE(check(std::int8_t(1)));
+        REQUIRE(check(std::uint16_t(3)));
+        REQUIRE(check(std::int32_t(-7)));
+        REQUIRE(check(std::uint32_t(1)));
+        REQUIRE(check(std::int64_t(1) << 40));
+        REQUIRE(check(std::uint64_t(123456789)));
+    }
+
+    SECTION("Floating point types") {
+        REQUIRE(check(0.37f));
+        REQUIRE(check(-1.0e200));
+
+        std::vector<double> source = {3.5, -std::numeric_limits<double>::infinity(), 0.0, -2.25, 1e-300,
+                                      std::numeric_limits<double>::infinity(), -1e-300, 42.0};
+        auto expected = source;
+        std::sort(expected.begin(), expected.end());
+        tools::radix_sort(source.begin(), source.end());
+
+        REQUIRE(source == expected);
+    }
+
+    SECTION("Input with equal high bytes and small input") {
+        std::vector<std::uint64_t> source = {5, 3, 4, 1, 2};
+        tools::radix_sort(source.begin(), source.end());
+        REQUIRE(source == std::vector<std::uint64_t>({1, 2, 3, 4, 5}));
+
+        std::vector<int> single = {1};
+        tools::radix_sort(policy, single.begin(), single.end());
+        REQUIRE(single.size() == 1);
+    }
+}
+
+TEST_CASE("Testing parallel_sort and parallel_stable_sort") {
+    std::mt19937 rng(4711);
+    tools::thread_pool pool(3);
+
+    SECTION("Strings with comparator and varying chunk counts") {
+        std::vector<std::string> source(3001);
+        std::uniform_int_distribution<int> distribution(0, 100000);
+        for (auto &s : source) s = std::to_string(distribution(rng));
+
+        const auto descending = std::greater<std::string>();
+        auto expected = source;
+        std::sort(expected.begin(), expected.end(), descending);
+
+        for (std::size_t n_chunks : {1, 2, 3, 7, 16}) {
+            auto sorted = source;
+            tools::parallel_sort(tools::parallel_policy(&pool, n_chunks), sorted.begin(), sorted.end(), descending);
+            REQUIRE(sorted == expected);
+        }
+    }
+
+    SECTION("Stable sort preserves the order of equal elements") {
+        std::vector<std::pair<int, int>> source(2000);
+        std::uniform_int_distribution<int> distribution(0, 20);
+        for (std::size_t i = 0; i < source.size(); ++i) source[i] = {distribution(rng), static_cast<int>(i)};
+
+        const auto by_key = [](const std::pair<int, int> &a, const std::pair<int, int> &b) { return a.first < b.first; };
+        auto expected = source;
+        std::stable_sort(expected.begin(), expected.end(), by_key);
+
+        auto sorted = source;
+        tools::parallel_stable_sort(tools::parallel_policy(&pool, 5), sorted.begin(), sorted.end(), by_key);
+        REQUIRE(sorted == expected);
+    }
+
+    SECTION("Small input and default comparator") {
+        std::vector<int> source = {3, 1, 2};
+        tools::parallel_sort(tools::parallel_policy(&pool, 8), source.begin(), source.end());
+        REQUIRE(source == std::vector<int>({1, 2, 3}));
+
+        source.clear();
+        tools::parallel_stable_sort(tools::par, source.begin(), source.end());
+        REQUIRE(source.empty());
+    }
+}
+
+TEST_CASE("Testing parallel sorted_vector") {
+    tools::thread_pool pool(2);
+
+    SECTION("Call with large r-value vector of arithmetic type") {
+        std::vector<double> source(3 * tools::radix_sort_threshold);
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+        for (auto &v : source) v = distribution(rng);
+
+        auto expected = source;
+        std::sort(expected.begin(), expected.end());
+
+        // The serial overload of vector_tools.h and the parallel overloads can be used together
+        const auto sortedVector = tools::sorted_vector(std::vector<double>(source));
+        REQUIRE(sortedVector == expected);
+
+        const auto parallelSortedVector = tools::sorted_vector(tools::parallel_policy(&pool), std::move(source));
+        REQUIRE(parallelSortedVector == expected);
+    }
+
+    SECTION("Call with comparator") {
+        const auto parallelSortedVector = tools::sorted_vector(tools::parallel_policy(&pool, 3), std::vector<std::string>({"bbb", "aaa", "ccc", "ddd"}),
+                                                               std::greater<std::string>());
+
+        REQUIRE(parallelSortedVector == std::vector<std::string>({"ddd", "ccc", "bbb", "aaa"}));
+    }
+}
+
+TEST_CASE("Testing adaptive set algorithms") {
+    std::mt19937 rng(1234);
+
+    // Returns a sorted vector of n random values in [0, max_value], contains duplicates if n is large compared to max_value
+    const auto random_sorted = [&](std::size_t n, int max_value) {
+        std::uniform_int_distribution<int> distribution(0, max_value);
+        std::vector<int> values(n);
+        for (auto &v : values) v = distribution(rng);
+        std::sort(values.begin(), values.end());
+        return values;
+    };
+
+    SECTION("Results match the std algorithms for similar and skewed sizes") {
+        for (const auto &sizes : std::vector<std::pair<std::size_t, std::size_t>>{{500, 600}, {10, 2000}, {3000, 20}, {0, 100}, {100, 0}}) {
+            const auto a = random_sorted(sizes.first, 1000);
+            const auto b = random_sorted(sizes.second, 1000);
+
+            std::vector<int> expected, result;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+            tools::adaptive_set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+            REQUIRE(result == expected);
+
+            expected.clear();
+            result.clear();
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+            tools::adaptive_set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+            REQUIRE(result == expected);
+
+            expected.clear();
+            result.clear();
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+            tools::adaptive_set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+            REQUIRE(result == expected);
+        }
+    }
+
+    SECTION("Generic path with comparator") {
+        const std::vector<std::string> a = {"z", "x", "m", "m", "c", "a"};
+        const std::vector<std::string> b = {"y", "x", "m", "b", "a"};
+        const auto descending = std::greater<std::string>();
+
+        std::vector<std::string> result;
+        tools::adaptive_set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result), descending);
+        REQUIRE(result == std::vector<std::string>({"x", "m", "a"}));
+
+        result.clear();
+        tools::adaptive_set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result), descending);
+        REQUIRE(result == std::vector<std::string>({"z", "m", "c"}));
+
+        result.clear();
+        tools::adaptive_set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result), descending);
+        REQUIRE(result == std::vector<std::string>({"z", "y", "x", "m", "m", "c", "b", "a"}));
+    }
+
+    SECTION("Multiway intersection") {
+        const auto a = random_sorted(2000, 3000);
+        const auto b = random_sorted(50, 3000);
+        const auto c = random_sorted(1500, 3000);
+
+        std::vector<int> ab, expected, result;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ab));
+        std::set_intersection(ab.begin(), ab.end(), c.begin(), c.end(), std::back_inserter(expected));
+
+        using range_t = tools::iterator_range<std::vector<int>::const_iterator>;
+        const std::vector<range_t> ranges = {range_t(a.begin(), a.end()), range_t(b.begin(), b.end()), range_t(c.begin(), c.end())};
+        tools::multiway_set_intersection(ranges, std::back_inserter(result));
+        REQUIRE(result == expected);
+
+        const std::vector<int> all = {1, 2, 3};
+        const std::vector<int> none;
+        result.clear();
+        tools::multiway_set_intersection(std::vector<range_t>{range_t(all.begin(), all.end()), range_t(none.begin(), none.end())},
+                                         std::back_inserter(result));
+        REQUIRE(result.empty());
+
+        tools::multiway_set_intersection(std::vector<range_t>{range_t(all.begin(), all.end())}, std::back_inserter(result));
+        REQUIRE(result == all);
+    }
+}
+
+TEST_CASE("Testing parallel merges") {
+    tools::thread_pool pool(3);
+    std::mt19937 gen(35);
+    std::uniform_int_distribution<int> dist(0, 200);
+
+    SECTION("Testing parallel_merge") {
+        for (std::size_t n_chunks : {1, 3, 8}) {
+            for (std::size_t sizes : {0, 1, 17, 5000}) {
+                std::vector<int> a(sizes), b(sizes / 3 + 2);
+                for (auto &x : a) x = dist(gen);
+                for (auto &x : b) x = dist(gen);
+                std::sort(a.begin(), a.end());
+                std::sort(b.begin(), b.end());
+
+                std::vector<int> expected;
+                std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+                std::vector<int> result(a.size() + b.size());
+                const auto end = tools::parallel_merge(tools::parallel_policy(&pool, n_chunks), a.begin(), a.end(), b.begin(), b.end(),
+                                                       result.begin());
+                REQUIRE(end == result.end());
+                REQUIRE(result == expected);
+            }
+        }
+    }
+
+    SECTION("Testing parallel_merge stability") {
+        using pair_t = std::pair<int, int>;
+        const auto by_first = [](const pair_t &l, const pair_t &r) { return l.first < r.first; };
+        std::vector<pair_t> a, b;
+        for (int i = 0; i < 1000; ++i) a.emplace_back(i / 10, 0);
+        for (int i = 0; i < 700; ++i) b.emplace_back(i / 7, 1);
+
+        std::vector<pair_t> expected;
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected), by_first);
+        std::vector<pair_t> result(a.size() + b.size());
+        tools::parallel_merge(tools::parallel_policy(&pool, 6), a.begin(), a.end(), b.begin(), b.end(), result.begin(), by_first);
+        REQUIRE(result == expected);
+    }
+
+    SECTION("Testing parallel_merge_many") {
+        using range_t = tools::iterator_range<std::vector<std::pair<int, int>>::const_iterator>;
+        for (std::size_t n_chunks : {1, 4, 9}) {
+            std::vector<std::vector<std::pair<int, int>>> inputs(7);
+            for (int k = 0; k < 7; ++k) {
+                inputs[k].resize(static_cast<std::size_t>(k * k * 100));
+                for (auto &x : inputs[k]) x = std::make_pair(dist(gen), k);
+                std::sort(inputs[k].begin(), inputs[k].end());
+            }
+
+            // Merging the ranges one after another with std::merge gives the same stable order
+            std::vector<std::pair<int, int>> expected;
+            std::vector<range_t> ranges;
+            for (const auto &input : inputs) {
+                std::vector<std::pair<int, int>> merged;
+                std::merge(expected.begin(), expected.end(), input.begin(), input.end(), std::back_inserter(merged),
+                           [](const auto &l, const auto &r) { return l.first < r.first; });
+                expected = std::move(merged);
+                ranges.emplace_back(input.begin(), input.end());
+            }
+
+            std::vector<std::pair<int, int>> result(expected.size());
+            const auto end = tools::parallel_merge_many(tools::parallel_policy(&pool, n_chunks), ranges, result.begin(),
+                                                        [](const auto &l, const auto &r) { return l.first < r.first; });
+            REQUIRE(end == result.end());
+            REQUIRE(result == expected);
+        }
+
+        std::vector<int> result;
+        REQUIRE(tools::parallel_merge_many(tools::par, std::vector<tools::iterator_range<int *>>(), result.begin()) == result.begin());
+        const std::vector<int> single = {1, 2, 2, 5};
+        result.resize(single.size());
+        tools::parallel_merge_many(tools::par, std::vector<tools::iterator_range<std::vector<int>::const_iterator>>{
+                tools::iterator_range<std::vector<int>::const_iterator>(single.begin(), single.end())}, result.begin());
+        REQUIRE(result == single);
+    }
+}
+
+TEST_CASE("Testing parallel scans and reduce") {
+    tools::thread_pool pool(3);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(-100, 100);
+
+    SECTION("Testing parallel_inclusive_scan and parallel_exclusive_scan") {
+        for (std::size_t n_chunks : {1, 3, 8, 1000}) {
+            for (std::size_t n : {1, 2, 9, 777}) {
+                std::vector<int> input(n);
+                for (auto &x : input) x = dist(gen);
+                const tools::parallel_policy policy(&pool, n_chunks);
+
+                std::vector<int> expected(n), result(n);
+                std::partial_sum(input.begin(), input.end(), expected.begin());
+                REQUIRE(tools::parallel_inclusive_scan(policy, input.begin(), input.end(), result.begin()) == result.end());
+                REQUIRE(result == expected);
+
+                std::vector<long long> expected_init(n), result_init(n);
+                long long acc = 1000;
+                for (std::size_t i = 0; i < n; ++i) expected_init[i] = (acc += input[i]);
+                tools::parallel_inclusive_scan(policy, input.begin(), input.end(), result_init.begin(), std::plus<>(), 1000LL);
+                REQUIRE(result_init == expected_init);
+
+                acc = 5;
+                for (std::size_t i = 0; i < n; ++i) {
+                    expected_init[i] = acc;
+                    acc += input[i];
+                }
+                REQUIRE(tools::parallel_exclusive_scan(policy, input.begin(), input.end(), result_init.begin(), 5LL) == result_init.end());
+                REQUIRE(result_init == expected_init);
+
+                // In-place scan
+                std::vector<int> in_place = input;
+                tools::parallel_exclusive_scan(policy, in_place.begin(), in_place.end(), in_place.begin(), 5);
+                REQUIRE(std::equal(in_place.begin(), in_place.end(), expected_init.begin(), expected_init.end(),
+                                   [](int a, long long b) { return a == b; }));
+            }
+        }
+    }
+
+    SECTION("Scans with non-commutative operations") {
+        const std::vector<std::string> input = {"a", "b", "c", "d", "e", "f", "g"};
+        std::vector<std::string> result(input.size());
+        tools::parallel_inclusive_scan(tools::parallel_policy(&pool, 3), input.begin(), input.end(), result.begin(), std::plus<>());
+        REQUIRE(result.back() == "abcdefg");
+        REQUIRE(result[2] == "abc");
+
+        tools::parallel_exclusive_scan(tools::parallel_policy(&pool, 4), input.begin(), input.end(), result.begin(), std::string(">"),
+                                       std::plus<>());
+        REQUIRE(result.front() == ">");
+        REQUIRE(result.back() == ">abcdef");
+    }
+
+    SECTION("Testing parallel_reduce") {
+        std::vector<int> input(10001);
+        for (auto &x : input) x = dist(gen);
+        const long long expected = std::accumulate(input.begin(), input.end(), 7LL);
+
+        for (std::size_t n_chunks : {1, 3, 16}) {
+            const tools::parallel_policy policy(&pool, n_chunks);
+            REQUIRE(tools::parallel_reduce(policy, input.begin(), input.end(), 7LL) == expected);
+            REQUIRE(tools::parallel_reduce(policy, input.begin(), input.end()) == expected - 7);
+            REQUIRE(tools::parallel_reduce(policy, input.begin(), input.end(), std::numeric_limits<int>::min(),
+                                           [](int a, int b) { return std::max(a, b); }) == *std::max_element(input.begin(), input.end()));
+        }
+
+        const std::vector<std::string> words = {"x", "y", "z"};
+        REQUIRE(tools::parallel_reduce(tools::parallel_policy(&pool, 2), words.begin(), words.end(), std::string("w")) == "wxyz");
+        REQUIRE(tools::parallel_reduce(tools::par, input.begin(), input.begin(), 3) == 3);
+    }
+}
+
+TEST_CASE("Testing deterministic_reduce") {
+    tools::thread_pool pool(3);
+    std::mt19937 gen(43);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    SECTION("Results are bit-identical for every partitioning") {
+        for (std::size_t n : {1, 127, 128, 129, 5000, 100003}) {
+            std::vector<float> input(n);
+            for (auto &x : input) x = dist(gen) * std::pow(10.0f, dist(gen) * 6.0f);
+
+            for (auto mode : {tools::summation_mode::pairwise, tools::summation_mode::compensated}) {
+                const float serial = tools::deterministic_reduce(input.begin(), input.end(), 0.5f, mode);
+                for (std::size_t n_chunks : {1, 2, 3, 7, 64}) {
+                    const float parallel = tools::deterministic_reduce(tools::parallel_policy(&pool, n_chunks), input.begin(), input.end(), 0.5f, mode);
+                    REQUIRE(std::memcmp(&serial, &parallel, sizeof(float)) == 0);
+                }
+            }
+        }
+    }
+
+    SECTION("Compensated summation is more accurate") {
+        std::vector<float> input(1000000, 0.1f);
+        input[0] = 1.0e6f;
+        double exact = 0.0;
+        for (float x : input) exact += x;
+
+        const float pairwise = tools::deterministic_reduce(tools::parallel_policy(&pool, 4), input.begin(), input.end(), 0.0f);
+        const float compensated = tools::deterministic_reduce(tools::parallel_policy(&pool, 4), input.begin(), input.end(), 0.0f,
+                                                              tools::summation_mode::compensated);
+        REQUIRE(std::abs(compensated - exact) <= std::abs(pairwise - exact));
+        REQUIRE(std::abs(compensated - exact) <= 0.125);
+    }
+
+    SECTION("Generic associative operations keep the element order") {
+        std::vector<std::string> input;
+        std::string expected = ">";
+        for (int i = 0; i < 1000; ++i) {
+            input.push_back(std::to_string(i % 10));
+            expected += input.back();
+        }
+
+        REQUIRE(tools::deterministic_reduce(input.begin(), input.end(), std::string(">"), std::plus<>()) == expected);
+        REQUIRE(tools::deterministic_reduce(tools::parallel_policy(&pool, 5), input.begin(), input.end(), std::string(">"), std::plus<>()) == expected);
+
+        const std::vector<int> empty;
+        REQUIRE(tools::deterministic_reduce(tools::par, empty.begin(), empty.end(), 42) == 42);
+    }
+
+    SECTION("Integral sums") {
+        std::vector<unsigned> input(10000);
+        std::iota(input.begin(), input.end(), 1u);
+        const unsigned expected = 10000u * 10001u / 2u;
+
+        REQUIRE(tools::deterministic_reduce(input.begin(), input.end(), 0u) == expected);
+        REQUIRE(tools::deterministic_reduce(tools::parallel_policy(&pool, 3), input.begin(), input.end(), 0u) == expected);
+        REQUIRE(tools::deterministic_reduce(input.begin(), input.end(), 0u, tools::summation_mode::compensated) == expected);
+        REQUIRE(tools::deterministic_reduce(tools::parallel_policy(&pool, 3), input.begin(), input.end(), 0u, tools::summation_mode::compensated) == expected);
+    }
+}
+
+TEST_CASE("Testing multiway_partition") {
+    tools::thread_pool pool(3);
+    std::mt19937 gen(45);
+
+    SECTION("Buckets are contiguous and keep the input order") {
+        for (std::size_t k : {1, 5, 300}) {
+            std::uniform_int_distribution<std::uint64_t> dist(0, 1000000);
+            std::vector<std::uint64_t> input(20000);
+            for (auto &x : input) x = dist(gen);
+            const auto bucket = [k](std::uint64_t x) { return static_cast<std::size_t>(x % k); };
+
+            std::vector<std::vector<std::uint64_t>> expected(k);
+            for (auto x : input) expected[bucket(x)].push_back(x);
+
+            for (std::size_t n_chunks : {0, 1, 4, 7}) {
+                std::vector<std::uint64_t> output(input.size());
+                const auto ranges = (n_chunks == 0)
+                                    ? tools::multiway_partition(input.begin(), input.end(), output.begin(), bucket, k)
+                                    : tools::multiway_partition(tools::parallel_policy(&pool, n_chunks), input.begin(), input.end(),
+                                                                output.begin(), bucket, k);
+                REQUIRE(ranges.size() == k);
+                REQUIRE(ranges.front().begin() == output.begin());
+                REQUIRE(ranges.back().end() == output.end());
+                for (std::size_t b = 0; b < k; ++b) {
+                    REQUIRE(std::equal(ranges[b].begin(), ranges[b].end(), expected[b].begin(), expected[b].end()));
+                }
+            }
+        }
+    }
+
+    SECTION("Elements that are not trivially copyable") {
+        const std::vector<std::string> input = {"pear", "fig", "apple", "kiwi", "plum", "date"};
+        std::vector<std::string> output(input.size());
+        const auto ranges = tools::multiway_partition(tools::parallel_policy(&pool, 2), input.begin(), input.end(), output.begin(),
+                                                      [](const std::string &s) { return s.size() - 3; }, 3);
+
+        REQUIRE(output == std::vector<std::string>({"fig", "pear", "kiwi", "plum", "date", "apple"}));
+        REQUIRE(ranges[1].size() == 4);
+    }
+}
+
+TEST_CASE("Testing count_by_key") {
+    tools::thread_pool pool(3);
+    std::mt19937 gen(46);
+
+    SECTION("Strings") {
+        std::uniform_int_distribution<int> dist(0, 2000);
+        std::vector<std::string> words(30000);
+        for (auto &w : words) w = "w" + std::to_string(dist(gen));
+
+        std::map<std::string, std::size_t> expected;
+        const auto equal_pair = [](const auto &lhs, const auto &rhs) { return lhs.first == rhs.first && lhs.second == rhs.second; };
+        for (const auto &w : words) expected[w]++;
+
+        for (std::size_t n_chunks : {0, 1, 3, 8}) {
+            const auto counts = (n_chunks == 0)
+                                ? tools::count_by_key(words.begin(), words.end())
+                                : tools::count_by_key(tools::parallel_policy(&pool, n_chunks), words.begin(), words.end());
+            REQUIRE(std::map<std::string, std::size_t>(counts.begin(), counts.end()) == expected);
+            REQUIRE(counts.size() == expected.size());
+
+            const auto sorted = (n_chunks == 0)
+                                ? tools::count_by_key_sorted(words.begin(), words.end())
+                                : tools::count_by_key_sorted(tools::parallel_policy(&pool, n_chunks), words.begin(), words.end());
+            REQUIRE(std::equal(sorted.begin(), sorted.end(), expected.begin(), expected.end(), equal_pair));
+        }
+    }
+
+    SECTION("Key function") {
+        const std::vector<std::string> words = {"pear", "fig", "apple", "kiwi", "plum", "date", "banana"};
+        const auto by_length = tools::count_by_key_sorted(tools::parallel_policy(&pool, 2), words.begin(), words.end(),
+                                                          [](const std::string &s) { return s.size(); });
+        REQUIRE(by_length == std::vector<std::pair<std::size_t, std::size_t>>({{3, 1}, {4, 4}, {5, 1}, {6, 1}}));
+
+        const auto by_initial = tools::count_by_key_sorted(words.begin(), words.end(), [](const std::string &s) { return std::string(1, s[0]); });
+        REQUIRE(by_initial.size() == 6);
+        REQUIRE(by_initial[5] == std::make_pair(std::string("p"), std::size_t(2)));
+    }
+
+    SECTION("Dense and sparse integral keys") {
+        for (std::int64_t max_key : {std::int64_t(50), std::int64_t(1) << 40}) {
+            std::uniform_int_distribution<std::int64_t> dist(-max_key, max_key);
+            std::vector<std::int64_t> values(20000);
+            for (auto &x : values) x = dist(gen) % 300 * (max_key / 50);
+
+            std::map<std::int64_t, std::size_t> expected;
+            const auto equal_pair = [](const auto &lhs, const auto &rhs) { return lhs.first == rhs.first && lhs.second == rhs.second; };
+            for (auto x : values) expected[x]++;
+
+            for (std::size_t n_chunks : {0, 1, 4}) {
+                const auto sorted = (n_chunks == 0)
+                                    ? tools::count_by_key_sorted(values.begin(), values.end())
+                                    : tools::count_by_key_sorted(tools::parallel_policy(&pool, n_chunks), values.begin(), values.end());
+                REQUIRE(std::equal(sorted.begin(), sorted.end(), expected.begin(), expected.end(), equal_pair));
+            }
+        }
+
+        const std::vector<unsigned char> bytes = {255, 0, 7, 255, 7, 7};
+        REQUIRE(tools::count_by_key(bytes.begin(), bytes.end())
+                == std::vector<std::pair<unsigned char, std::size_t>>({{0, 1}, {7, 3}, {255, 2}}));
+    }
+
+    SECTION("Empty range") {
+        const std::vector<int> empty;
+        REQUIRE(tools::count_by_key(empty.begin(), empty.end()).empty());
+        REQUIRE(tools::count_by_key_sorted(tools::parallel_policy(&pool), empty.begin(), empty.end()).empty());
+    }
+}
+
 TEST_CASE("Testing make_output_iterator_adapter") {
     SECTION("Testing in-place constructed, generic lambda") {
         const std::array<int, 7> a1{0, 10, 20, 30, 40, 50, 60};
@@ -279,3 +1341,231 @@ TEST_CASE("Testing make_output_iterator_adapter") {
         REQUIRE(std::equal(out1.begin(), out1.end(), out2.begin(), out2.end()) == true);
     }
 }
+
+TEST_CASE("Testing make_buffered_output_iterator_adapter") {
+    SECTION("Values are forwarded in batches") {
+        const std::vector<int> input = {1, 1, 2, 3, 3, 3, 4, 5, 6, 6, 7, 8};
+        std::vector<int> expected;
+        tools::strict_unique_copy(input.begin(), input.end(), std::back_inserter(expected));
+
+        std::vector<int> result;
+        std::vector<std::size_t> batch_sizes;
+        {
+            auto out = tools::make_buffered_output_iterator_adapter<int, 2>([&](tools::iterator_range<int *> batch) {
+                batch_sizes.push_back(batch.size());
+                result.insert(result.end(), batch.begin(), batch.end());
+            });
+            out = tools::strict_unique_copy(input.begin(), input.end(), std::move(out));
+            REQUIRE(batch_sizes == std::vector<std::size_t>({2, 2}));
+        }
+
+        REQUIRE(result == expected);
+        REQUIRE(batch_sizes == std::vector<std::size_t>({2, 2, 1}));
+    }
+
+    SECTION("Explicit flush and copies") {
+        std::vector<std::string> result;
+        auto out = tools::make_buffered_output_iterator_adapter<std::string, 8>([&](tools::iterator_range<std::string *> batch) {
+            std::move(batch.begin(), batch.end(), std::back_inserter(result));
+        });
+
+        *out++ = "a";
+        *out++ = std::string("b");
+        REQUIRE(result.empty());
+        out.flush();
+        REQUIRE(result == std::vector<std::string>({"a", "b"}));
+
+        *out++ = "c";
+        auto copy = out;
+        REQUIRE(result.size() == 3);
+        *copy++ = "d";
+        copy.flush();
+        REQUIRE(result == std::vector<std::string>({"a", "b", "c", "d"}));
+    }
+
+    SECTION("Move-only callable") {
+        struct move_only_sum {
+            std::unique_ptr<int> sum;
+
+            void operator()(tools::iterator_range<int *> values) const {
+                for (int v : values) *sum += v;
+            }
+        };
+
+        auto sum = std::make_unique<int>(0);
+        const int *total = sum.get();
+        auto out = tools::make_buffered_output_iterator_adapter<int, 2>(move_only_sum{std::move(sum)});
+        *out++ = 1;
+        *out++ = 2;
+        *out++ = 3;
+        REQUIRE(*total == 3);
+
+        auto moved = std::move(out);
+        *moved++ = 4;
+        auto other = tools::make_buffered_output_iterator_adapter<int, 2>(move_only_sum{std::make_unique<int>(0)});
+        other = std::move(moved);
+        *other++ = 5;
+        other.flush();
+        REQUIRE(*total == 15);
+    }
+
+    SECTION("Throwing callable") {
+        std::vector<int> result;
+        bool fail = true;
+        {
+            auto out = tools::make_buffered_output_iterator_adapter<int, 4>([&](tools::iterator_range<int *> batch) {
+                if (fail) throw std::runtime_error("sink unavailable");
+                result.insert(result.end(), batch.begin(), batch.end());
+            });
+            *out++ = 1;
+            *out++ = 2;
+
+            // The values stay buffered until an explicit flush succeeds
+            REQUIRE_THROWS_AS(out.flush(), std::runtime_error);
+            fail = false;
+            out.flush();
+            REQUIRE(result == std::vector<int>({1, 2}));
+
+            // The destructor drops the values instead of terminating
+            *out++ = 3;
+            fail = true;
+        }
+        REQUIRE(result == std::vector<int>({1, 2}));
+    }
+}
+
+TEST_CASE("Testing parallel_top_k") {
+    tools::thread_pool pool(3);
+    std::mt19937 gen(47);
+    std::uniform_int_distribution<int> dist(-100000, 100000);
+    std::vector<int> values(10000);
+    for (auto &x : values) x = dist(gen);
+
+    SECTION("Agrees with partial_sort") {
+        for (std::size_t k : {0, 1, 10, 500, 3000, 10000, 20000}) {
+            const std::size_t m = std::min(k, values.size());
+            auto expected_smallest = values;
+            std::partial_sort(expected_smallest.begin(), expected_smallest.begin() + m, expected_smallest.end());
+            expected_smallest.resize(m);
+            auto expected_largest = values;
+            std::partial_sort(expected_largest.begin(), expected_largest.begin() + m, expected_largest.end(), std::greater<>());
+            expected_largest.resize(m);
+
+            for (std::size_t n_chunks : {1, 3, 16}) {
+                const tools::parallel_policy policy(&pool, n_chunks);
+                REQUIRE(tools::parallel_top_k(policy, values.begin(), values.end(), k) == expected_smallest);
+                REQUIRE(tools::parallel_top_k(policy, values.begin(), values.end(), k, std::greater<>()) == expected_largest);
+            }
+        }
+    }
+
+    SECTION("Default policy") {
+        auto expected = values;
+        std::partial_sort(expected.begin(), expected.begin() + 5, expected.end(), std::greater<>());
+        expected.resize(5);
+        REQUIRE(tools::parallel_top_k(values.begin(), values.end(), 5, std::greater<>()) == expected);
+        REQUIRE(tools::parallel_top_k(values.begin(), values.end(), 0).empty());
+    }
+
+    SECTION("Scored entries") {
+        const std::vector<std::pair<std::string, double>> scores = {{"a", 0.5}, {"b", 2.0}, {"c", -1.0}, {"d", 3.5}, {"e", 1.0}};
+        const auto top = tools::parallel_top_k(tools::parallel_policy(&pool, 2), scores.begin(), scores.end(), 2,
+                                               [](const auto &lhs, const auto &rhs) { return lhs.second > rhs.second; });
+        REQUIRE(top.size() == 2);
+        REQUIRE(top[0].first == "d");
+        REQUIRE(top[1].first == "b");
+    }
+
+    SECTION("Streaming accumulator") {
+        tools::top_k_accumulator<int> lower(20), upper(20);
+        std::copy(values.begin(), values.begin() + 5000, lower.output_iterator());
+        std::copy(values.begin() + 5000, values.end(), upper.output_iterator());
+        REQUIRE(lower.size() == 20);
+        REQUIRE(lower.k() == 20);
+
+        lower.merge(upper);
+        auto expected = values;
+        std::partial_sort(expected.begin(), expected.begin() + 20, expected.end());
+        expected.resize(20);
+        REQUIRE(lower.sorted_values() == expected);
+
+        lower.merge(lower);
+        REQUIRE(lower.sorted_values() == expected);
+
+        tools::top_k_accumulator<std::string, std::greater<>> last_words(2);
+        for (std::string s : {"kiwi", "apple", "fig", "pear"}) last_words.push(std::move(s));
+        REQUIRE(last_words.sorted_values() == std::vector<std::string>({"pear", "kiwi"}));
+
+        last_words.clear();
+        REQUIRE(last_words.size() == 0);
+    }
+}
+
+TEST_CASE("Testing merge_join") {
+    tools::thread_pool pool(3);
+
+    SECTION("Duplicate keys on both sides") {
+        const std::vector<std::pair<int, char>> left = {{1, 'a'}, {2, 'b'}, {2, 'c'}, {4, 'd'}, {5, 'e'}, {5, 'f'}};
+        const std::vector<std::pair<int, std::string>> right = {{0, "x"}, {2, "y"}, {2, "z"}, {2, "w"}, {5, "v"}, {6, "u"}};
+        const auto key = [](const auto &p) { return p.first; };
+
+        std::vector<std::string> joined;
+        tools::merge_join(left.begin(), left.end(), right.begin(), right.end(), key, key, [&joined](const auto &a, const auto &b) {
+            joined.push_back(a.second + b.second);
+        });
+        REQUIRE(joined == std::vector<std::string>({"by", "bz", "bw", "cy", "cz", "cw", "ev", "fv"}));
+
+        std::vector<std::pair<std::pair<int, char>, std::pair<int, std::string>>> pairs;
+        tools::merge_join_copy(left.begin(), left.end(), right.begin(), right.end(), key, key, std::back_inserter(pairs));
+        REQUIRE(pairs.size() == 8);
+        REQUIRE(pairs[3].first.second == 'c');
+        REQUIRE(pairs[3].second.second == "y");
+    }
+
+    SECTION("Without key functions") {
+        const std::vector<int> a = {1, 1, 3, 4};
+        const std::list<int> b = {1, 3, 3, 7};
+        std::vector<std::pair<int, int>> pairs;
+        tools::merge_join_copy(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(pairs));
+        REQUIRE(pairs == std::vector<std::pair<int, int>>({{1, 1}, {1, 1}, {3, 3}, {3, 3}}));
+
+        int count = 0;
+        tools::merge_join(a.begin(), a.end(), a.begin(), a.end(), [&count](int, int) { ++count; });
+        REQUIRE(count == 6);
+    }
+
+    SECTION("Parallel join agrees with the serial join") {
+        std::mt19937 gen(49);
+        for (int max_key : {5, 100, 5000}) {
+            std::uniform_int_distribution<int> dist(0, max_key);
+            std::vector<std::pair<int, int>> left(3000), right(2000);
+            for (std::size_t i = 0; i < left.size(); ++i) left[i] = std::make_pair(dist(gen), static_cast<int>(i));
+            for (std::size_t i = 0; i < right.size(); ++i) right[i] = std::make_pair(dist(gen), -static_cast<int>(i));
+            std::stable_sort(left.begin(), left.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+            std::stable_sort(right.begin(), right.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+            const auto key = [](const std::pair<int, int> &p) { return p.first; };
+
+            std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> expected;
+            for (const auto &a : left) {
+                for (const auto &b : right) {
+                    if (a.first == b.first) expected.emplace_back(a, b);
+                }
+            }
+
+            for (std::size_t n_chunks : {1, 3, 16}) {
+                const tools::parallel_policy policy(&pool, n_chunks);
+                std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> output(expected.size() + 1);
+                const auto output_end = tools::merge_join_copy(policy, left.begin(), left.end(), right.begin(), right.end(), key, key, output.begin());
+                REQUIRE(output_end == output.begin() + static_cast<std::ptrdiff_t>(expected.size()));
+                output.pop_back();
+                REQUIRE(output == expected);
+
+                std::atomic<std::size_t> count(0);
+                tools::merge_join(policy, left.begin(), left.end(), right.begin(), right.end(), key, key, [&count](const auto &a, const auto &b) {
+                    if (a.first == b.first) count++;
+                });
+                REQUIRE(count == expected.size());
+            }
+        }
+    }
+}
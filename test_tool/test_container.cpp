@@ -0,0 +1,446 @@
+//	MIT License
+//
+//	Copyright (c) 2020 Fabian Löschner
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include <noname_tools/container_tools.h>
+#include <noname_tools/file_tools.h>
+#include <noname_tools/parallel_tools.h>
+
+#include "catch2/catch.hpp"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <utility>
+
+using namespace noname;
+
+template<typename T>
+using read_all_lines_t = decltype(tools::read_all_lines(std::string(), std::declval<T>()));
+
+namespace {
+    // Uniquely named file in the temporary directory which is removed when it goes out of scope
+    struct temp_file {
+        std::string path;
+
+        explicit temp_file(const std::string &name) {
+            const char *dir = std::getenv("TMPDIR");
+            if (dir == nullptr) dir = std::getenv("TEMP");
+            path = std::string(dir != nullptr ? dir : "/tmp") + "/" + name + "_" + std::to_string(std::random_device()()) + ".txt";
+        }
+
+        ~temp_file() { std::remove(path.c_str()); }
+    };
+}
+
+TEST_CASE("Testing flat_set") {
+    SECTION("Construction sorts and removes duplicates") {
+        const tools::flat_set<int> set = {5, 1, 3, 1, 5};
+
+        REQUIRE(set.size() == 3);
+        REQUIRE(set.sequence() == std::vector<int>({1, 3, 5}));
+        REQUIRE(set.contains(3));
+        REQUIRE(!set.contains(2));
+        REQUIRE(set.count(5) == 1);
+        REQUIRE(*set.lower_bound(2) == 3);
+        REQUIRE(*set.upper_bound(3) == 5);
+        REQUIRE(set.find(4) == set.end());
+    }
+
+    SECTION("Single and bulk insertion") {
+        tools::flat_set<int> set = {10, 20, 30};
+
+        REQUIRE(set.insert(15).second == true);
+        REQUIRE(set.insert(15).second == false);
+        REQUIRE(*set.insert(20).first == 20);
+
+        const std::vector<int> batch = {40, 5, 20, 25, 5};
+        set.insert(batch.begin(), batch.end());
+        REQUIRE(set.sequence() == std::vector<int>({5, 10, 15, 20, 25, 30, 40}));
+
+        set.insert({1, 50});
+        REQUIRE(set.size() == 9);
+    }
+
+    SECTION("Erase") {
+        tools::flat_set<int> set = {1, 2, 3};
+
+        REQUIRE(set.erase(2) == 1);
+        REQUIRE(set.erase(2) == 0);
+        set.erase(set.begin());
+        REQUIRE(set.sequence() == std::vector<int>({3}));
+    }
+
+    SECTION("Heterogeneous lookup with transparent comparator") {
+        const tools::flat_set<std::string, std::less<>> set = {"banana", "apple", "cherry"};
+
+        REQUIRE(set.contains("apple"));
+        REQUIRE(!set.contains("date"));
+        REQUIRE(*set.find("cherry") == "cherry");
+    }
+
+    SECTION("Custom comparator") {
+        const tools::flat_set<int, std::greater<int>> set = {1, 3, 2};
+
+        REQUIRE(set.sequence() == std::vector<int>({3, 2, 1}));
+        REQUIRE(set.contains(2));
+    }
+}
+
+TEST_CASE("Testing flat_map") {
+    SECTION("Lookup and modification") {
+        tools::flat_map<std::string, int> map = {{"b", 2}, {"a", 1}, {"c", 3}};
+
+        REQUIRE(map.size() == 3);
+        REQUIRE(map.begin()->first == "a");
+        REQUIRE(map.at("b") == 2);
+        REQUIRE_THROWS_AS(map.at("d"), std::out_of_range);
+
+        map["b"] += 40;
+        map["d"] = 4;
+        REQUIRE(map.at("b") == 42);
+        REQUIRE(map.size() == 4);
+
+        map.find("a")->second = 7;
+        REQUIRE(map["a"] == 7);
+    }
+
+    SECTION("Bulk insertion keeps the existing and first inserted values") {
+        tools::flat_map<int, std::string> map = {{1, "one"}, {3, "three"}};
+        const std::vector<std::pair<int, std::string>> batch = {{2, "two"}, {3, "drei"}, {2, "zwei"}, {4, "four"}};
+
+        map.insert(batch.begin(), batch.end());
+
+        REQUIRE(map.size() == 4);
+        REQUIRE(map.at(2) == "two");
+        REQUIRE(map.at(3) == "three");
+        REQUIRE(map.insert({5, "five"}).second == true);
+        REQUIRE(map.erase(1) == 1);
+        REQUIRE(map.begin()->first == 2);
+    }
+
+    SECTION("Erase through mutable iterators") {
+        tools::flat_map<std::string, int> map = {{"a", 1}, {"b", 2}, {"c", 3}};
+
+        const auto next = map.erase(map.begin());
+        REQUIRE(next->first == "b");
+        map.erase(map.find("c"));
+        REQUIRE(map.size() == 1);
+        REQUIRE(map.erase("b") == 1);
+        REQUIRE(map.empty());
+
+        tools::flat_map<std::string, int, std::less<>> transparent_map = {{"a", 1}, {"b", 2}};
+        transparent_map.erase(transparent_map.begin());
+        REQUIRE(transparent_map.erase("b") == 1);
+        REQUIRE(transparent_map.empty());
+    }
+
+    SECTION("Heterogeneous lookup only with transparent comparators") {
+        const tools::flat_map<std::string, int, std::less<>> map = {{"a", 1}, {"b", 2}};
+        REQUIRE(map.at("b") == 2);
+        REQUIRE(map.count("c") == 0);
+
+        struct counting_less {
+            bool operator()(const std::string &a, const std::string &b) const { return a < b; }
+        };
+        const tools::flat_map<std::string, int, counting_less> opaque_map = {{"a", 1}, {"b", 2}};
+        REQUIRE(opaque_map.at("a") == 1);
+        REQUIRE(opaque_map.contains("b"));
+    }
+}
+
+TEST_CASE("Testing eytzinger_tree") {
+    SECTION("lower_bound matches std::lower_bound for all tree sizes") {
+        for (int n = 0; n < 70; ++n) {
+            std::vector<int> sorted(static_cast<std::size_t>(n));
+            for (int i = 0; i < n; ++i) sorted[static_cast<std::size_t>(i)] = 2 * i;
+            const tools::eytzinger_tree<int> tree(sorted);
+            REQUIRE(tree.size() == sorted.size());
+
+            for (int key = -1; key <= 2 * n; ++key) {
+                const auto expected = std::lower_bound(sorted.begin(), sorted.end(), key);
+                const int *result = tree.lower_bound(key);
+                if (expected == sorted.end()) {
+                    REQUIRE(result == nullptr);
+                } else {
+                    REQUIRE(result != nullptr);
+                    REQUIRE(*result == *expected);
+                }
+                REQUIRE(tree.contains(key) == std::binary_search(sorted.begin(), sorted.end(), key));
+            }
+        }
+    }
+
+    SECTION("Duplicates, strings and heterogeneous keys") {
+        const std::vector<std::string> sorted = {"a", "b", "b", "b", "c", "e"};
+        const tools::eytzinger_tree<std::string, std::less<>> tree(sorted);
+
+        REQUIRE(*tree.lower_bound("b") == "b");
+        REQUIRE(*tree.lower_bound("d") == "e");
+        REQUIRE(tree.lower_bound("f") == nullptr);
+        REQUIRE(tree.contains("c"));
+        REQUIRE(!tree.contains("d"));
+    }
+
+    SECTION("Empty tree") {
+        const tools::eytzinger_tree<double> tree;
+
+        REQUIRE(tree.empty());
+        REQUIRE(tree.lower_bound(1.0) == nullptr);
+        REQUIRE(!tree.contains(1.0));
+    }
+}
+
+TEST_CASE("Testing small_vector") {
+    SECTION("Elements stay inline up to the inline capacity") {
+        tools::small_vector<int, 4> vector;
+        for (int i = 0; i < 4; ++i) vector.push_back(i);
+
+        REQUIRE(vector.is_inline());
+        REQUIRE(vector.size() == 4);
+        REQUIRE(vector.capacity() == 4);
+        REQUIRE(vector == tools::small_vector<int, 4>({0, 1, 2, 3}));
+
+        vector.push_back(4);
+        REQUIRE(!vector.is_inline());
+        REQUIRE(vector.capacity() >= 5);
+        REQUIRE(std::vector<int>(vector.begin(), vector.end()) == std::vector<int>({0, 1, 2, 3, 4}));
+    }
+
+    SECTION("Growth from a reference to an own element") {
+        tools::small_vector<std::string, 1> vector = {"abc"};
+        vector.push_back(vector[0]);
+        vector.push_back(vector[1]);
+
+        REQUIRE(vector.size() == 3);
+        REQUIRE(vector.back() == "abc");
+    }
+
+    SECTION("Copy and move of inline and heap storage") {
+        for (std::size_t n : {2, 20}) {
+            tools::small_vector<std::string, 3> original;
+            for (std::size_t i = 0; i < n; ++i) original.emplace_back(std::to_string(i));
+
+            tools::small_vector<std::string, 3> copy(original);
+            REQUIRE(copy == original);
+
+            const std::string *heap_data = original.data();
+            tools::small_vector<std::string, 3> moved(std::move(original));
+            REQUIRE(moved == copy);
+            REQUIRE(original.empty());
+            REQUIRE(moved.is_inline() == (n <= 3));
+            if (n > 3) REQUIRE(moved.data() == heap_data);
+
+            original = moved;
+            REQUIRE(original == copy);
+            moved = std::move(copy);
+            REQUIRE(moved == original);
+        }
+    }
+
+    SECTION("Resize, erase and element access") {
+        tools::small_vector<std::unique_ptr<int>, 2> vector;
+        vector.resize(3);
+        REQUIRE(vector.size() == 3);
+        REQUIRE(vector[2] == nullptr);
+
+        vector[0] = std::make_unique<int>(0);
+        vector[2] = std::make_unique<int>(2);
+        vector.erase(vector.begin() + 1);
+        REQUIRE(vector.size() == 2);
+        REQUIRE(*vector.front() == 0);
+        REQUIRE(*vector.back() == 2);
+        REQUIRE_THROWS_AS(vector.at(2), std::out_of_range);
+
+        vector.clear();
+        REQUIRE(vector.empty());
+    }
+}
+
+TEST_CASE("Testing segmented_vector") {
+    SECTION("Element addresses stay valid while the vector grows") {
+        tools::segmented_vector<int, 4> vector;
+        vector.push_back(0);
+        const int *first = &vector[0];
+        for (int i = 1; i < 100; ++i) vector.push_back(i);
+
+        REQUIRE(&vector[0] == first);
+        REQUIRE(vector.size() == 100);
+        REQUIRE(vector.capacity() == 100);
+        REQUIRE(vector[57] == 57);
+        REQUIRE(vector.back() == 99);
+        REQUIRE_THROWS_AS(vector.at(100), std::out_of_range);
+    }
+
+    SECTION("Random access iterators") {
+        tools::segmented_vector<int, 8> vector;
+        for (int i = 0; i < 50; ++i) vector.push_back(49 - i);
+
+        std::sort(vector.begin(), vector.end());
+        REQUIRE(std::is_sorted(vector.cbegin(), vector.cend()));
+        REQUIRE(vector.end() - vector.begin() == 50);
+        REQUIRE(*std::lower_bound(vector.begin(), vector.end(), 20) == 20);
+
+        tools::segmented_vector<int, 8>::const_iterator it = vector.begin() + 10;
+        REQUIRE(it[5] == 15);
+    }
+
+    SECTION("Copy, move and append") {
+        tools::segmented_vector<std::string, 2> vector = {"a", "b", "c"};
+        const std::string *address = &vector[2];
+
+        tools::segmented_vector<std::string, 2> moved(std::move(vector));
+        REQUIRE(vector.empty());
+        REQUIRE(&moved[2] == address);
+
+        tools::segmented_vector<std::string, 2> copy(moved);
+        REQUIRE(std::equal(copy.begin(), copy.end(), moved.begin(), moved.end()));
+
+        // The blocks of the appended vector are taken over if the vector ends at a block boundary
+        copy.push_back("d");
+        tools::segmented_vector<std::string, 2> other = {"e", "f", "g"};
+        const std::string *other_address = &other[0];
+        copy.append(std::move(other));
+        REQUIRE(other.empty());
+        REQUIRE(copy.size() == 7);
+        REQUIRE(&copy[4] == other_address);
+
+        copy.append(tools::segmented_vector<std::string, 2>({"h", "i"}));
+        REQUIRE(std::vector<std::string>(copy.begin(), copy.end()) ==
+                std::vector<std::string>({"a", "b", "c", "d", "e", "f", "g", "h", "i"}));
+
+        // Appending a vector to itself leaves it unchanged
+        copy.append(std::move(copy));
+        REQUIRE(copy.size() == 9);
+        REQUIRE(copy.back() == "i");
+
+        copy.clear();
+        copy.shrink_to_fit();
+        REQUIRE(copy.capacity() == 0);
+    }
+
+    SECTION("Line readers write into the vector") {
+        const temp_file temp("noname_test_segmented_lines");
+        const std::string &path = temp.path;
+        {
+            std::ofstream file(path);
+            for (int i = 0; i < 10; ++i) file << "line " << i << "\n";
+        }
+
+        tools::segmented_vector<std::string, 4> lines;
+        REQUIRE(tools::read_all_lines(path, lines) == 10);
+        REQUIRE(lines.size() == 10);
+        REQUIRE(lines[9] == "line 9");
+
+        REQUIRE(tools::read_lines(path, 3, lines) == 3);
+        REQUIRE(lines.size() == 13);
+        REQUIRE(lines.back() == "line 2");
+
+        // Const or temporary segmented vectors must not be taken for an allocator
+        REQUIRE_FALSE((tools::is_detected<read_all_lines_t, const tools::segmented_vector<std::string, 4> &>::value));
+        REQUIRE_FALSE((tools::is_detected<read_all_lines_t, tools::segmented_vector<std::string, 4>>::value));
+        REQUIRE((tools::is_detected<read_all_lines_t, std::allocator<int>>::value));
+    }
+}
+
+TEST_CASE("Testing concurrent_append_vector") {
+    tools::thread_pool pool(3);
+
+    SECTION("Indices are claimed without gaps") {
+        tools::concurrent_append_vector<int, 4> vector;
+        REQUIRE(vector.push_back(7) == 0);
+        REQUIRE(vector.emplace_back(8) == 1);
+        const std::vector<int> values = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        REQUIRE(vector.append(values.begin(), values.end()) == 2);
+
+        REQUIRE(vector.size() == 12);
+        REQUIRE(vector[0] == 7);
+        REQUIRE(vector[11] == 10);
+        REQUIRE(std::equal(vector.begin() + 2, vector.end(), values.begin(), values.end()));
+
+        vector.clear();
+        REQUIRE(vector.empty());
+    }
+
+    SECTION("Concurrent push_back from many tasks") {
+        tools::concurrent_append_vector<std::string, 8> vector;
+        tools::concurrent_append_vector<int> numbers;
+        numbers.push_back(-1);
+        const int *address = &numbers[0];
+
+        pool.parallel_for(16, [&](std::size_t task) {
+            for (int i = 0; i < 500; ++i) {
+                vector.push_back(std::to_string(task * 1000 + i));
+                numbers.push_back(static_cast<int>(task * 1000 + i));
+            }
+        });
+
+        REQUIRE(vector.size() == 8000);
+        REQUIRE(&numbers[0] == address);
+        std::vector<int> sorted(numbers.begin() + 1, numbers.end());
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+        REQUIRE(sorted.front() == 0);
+        REQUIRE(sorted.back() == 15499);
+    }
+
+    SECTION("Appenders and output iterators") {
+        tools::concurrent_append_vector<int> vector;
+        std::vector<int> input(1000);
+        for (std::size_t i = 0; i < input.size(); ++i) input[i] = static_cast<int>(i);
+
+        pool.parallel_for(4, [&](std::size_t task) {
+            auto appender = vector.make_appender(32);
+            const auto first = input.begin() + static_cast<std::ptrdiff_t>(task * 250);
+            std::copy_if(first, first + 250, appender.output_iterator(), [](int x) { return x % 2 == 0; });
+        });
+        REQUIRE(vector.size() == 500);
+
+        std::copy(input.begin(), input.begin() + 10, vector.output_iterator());
+        REQUIRE(vector.size() == 510);
+
+        std::vector<int> sorted(vector.begin(), vector.begin() + 500);
+        std::sort(sorted.begin(), sorted.end());
+        for (std::size_t i = 0; i < sorted.size(); ++i) REQUIRE(sorted[i] == static_cast<int>(2 * i));
+    }
+
+    SECTION("Throwing construction does not claim an index") {
+        tools::concurrent_append_vector<std::string> vector;
+        vector.push_back("a");
+
+        REQUIRE_THROWS_AS(vector.emplace_back(static_cast<const char *>(nullptr)), std::logic_error);
+        REQUIRE(vector.size() == 1);
+
+        const std::vector<const char *> values = {"b", nullptr};
+        REQUIRE_THROWS_AS(vector.append(values.begin(), values.end()), std::logic_error);
+        REQUIRE(vector.size() == 1);
+
+        REQUIRE(vector.append(values.begin(), values.begin() + 1) == 1);
+        REQUIRE(vector[1] == "b");
+    }
+}
@@ -0,0 +1,190 @@
+//	MIT License
+//
+//	Copyright (c) 2020 Fabian Löschner
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include <noname_tools/memory_tools.h>
+#include <noname_tools/file_tools.h>
+#include <noname_tools/string_tools.h>
+#include <noname_tools/vector_tools.h>
+
+#include "catch2/catch.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace noname;
+
+namespace {
+    // Uniquely named file in the temporary directory which is removed when it goes out of scope
+    struct temp_file {
+        std::string path;
+
+        explicit temp_file(const std::string &name) {
+            const char *dir = std::getenv("TMPDIR");
+            if (dir == nullptr) dir = std::getenv("TEMP");
+            path = std::string(dir != nullptr ? dir : "/tmp") + "/" + name + "_" + std::to_string(std::random_device()()) + ".txt";
+        }
+
+        ~temp_file() { std::remove(path.c_str()); }
+    };
+}
+
+TEST_CASE("Testing monotonic_arena") {
+    SECTION("Allocations are aligned and counted") {
+        tools::monotonic_arena arena(64);
+        for (std::size_t alignment : {1, 2, 8, 16, 64, 256}) {
+            void *p = arena.allocate(3, alignment);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(p) % alignment == 0);
+        }
+        REQUIRE(arena.bytes_allocated() == 18);
+
+        void *large = arena.allocate(10000);
+        REQUIRE(large != nullptr);
+        REQUIRE(arena.bytes_held() >= 10000);
+    }
+
+    SECTION("Reset keeps the largest block and reuses its memory") {
+        tools::monotonic_arena arena(16);
+        for (int i = 0; i < 100; ++i) (void) arena.allocate(100);
+        arena.reset();
+
+        const std::size_t held = arena.bytes_held();
+        REQUIRE(arena.bytes_allocated() == 0);
+        REQUIRE(held >= 100);
+        (void) arena.allocate(held / 2);
+        REQUIRE(arena.bytes_held() == held);
+
+        arena.release();
+        REQUIRE(arena.bytes_held() == 0);
+    }
+}
+
+TEST_CASE("Testing pool_resource") {
+    SECTION("Deallocated memory is reused by allocations of the same size class") {
+        tools::pool_resource pool;
+        void *a = pool.allocate(24, 8);
+        pool.deallocate(a, 24, 8);
+        REQUIRE(pool.allocate(32, 8) == a);
+
+        void *large = pool.allocate(100000);
+        REQUIRE(pool.bytes_allocated() >= 100000);
+        pool.deallocate(large, 100000);
+        REQUIRE(pool.bytes_allocated() < 100000);
+    }
+
+    SECTION("Reset releases all memory") {
+        tools::pool_resource pool(256);
+        for (int i = 0; i < 100; ++i) {
+            (void) pool.allocate(64);
+            (void) pool.allocate(5000);
+        }
+        pool.reset();
+        REQUIRE(pool.bytes_allocated() == 0);
+    }
+}
+
+TEST_CASE("Testing arena_allocator") {
+    SECTION("Containers allocate from the arena") {
+        tools::monotonic_arena arena;
+        std::vector<int, tools::arena_allocator<int>> vector{tools::arena_allocator<int>(arena)};
+        for (int i = 0; i < 1000; ++i) vector.push_back(i);
+
+        REQUIRE(vector[999] == 999);
+        REQUIRE(arena.bytes_allocated() >= 1000 * sizeof(int));
+        REQUIRE(vector.get_allocator() == tools::arena_allocator<char>(arena));
+    }
+
+    SECTION("Containers allocate from the pool") {
+        tools::pool_resource pool;
+        using alloc_t = tools::arena_allocator<std::string, tools::pool_resource>;
+        std::vector<std::string, alloc_t> vector{alloc_t(pool)};
+        for (int i = 0; i < 100; ++i) vector.emplace_back(std::to_string(i));
+
+        REQUIRE(vector[42] == "42");
+        REQUIRE(pool.bytes_allocated() > 0);
+    }
+}
+
+TEST_CASE("Testing allocator-aware overloads") {
+    tools::monotonic_arena arena;
+    const tools::arena_allocator<char> alloc(arena);
+
+    SECTION("Testing split_string") {
+        const auto strings = tools::split_string(std::string("ab,cd,,e"), ',', alloc);
+
+        REQUIRE((std::is_same<decltype(strings)::value_type, tools::alloc_string_t<tools::arena_allocator<char>>>::value) == true);
+        REQUIRE(strings.size() == 4);
+        REQUIRE(strings[0] == "ab");
+        REQUIRE(strings[2].empty());
+        REQUIRE(strings[3] == "e");
+        REQUIRE(strings.get_allocator() == alloc);
+    }
+
+    SECTION("Testing read_all_lines and read_lines") {
+        const temp_file temp("noname_test_memory_lines");
+        const std::string &path = temp.path;
+        {
+            std::ofstream file(path);
+            file << "first\nsecond line\nthird\n";
+        }
+
+        const auto lines = tools::read_all_lines(path, alloc);
+        REQUIRE(lines.size() == 3);
+        REQUIRE(lines[1] == "second line");
+        REQUIRE(lines[1].get_allocator() == alloc);
+
+        const auto first_lines = tools::read_lines(path, 2, alloc);
+        REQUIRE(first_lines.size() == 2);
+        REQUIRE(first_lines[1] == "second line");
+        REQUIRE(first_lines[1].get_allocator() == alloc);
+    }
+
+    SECTION("Testing sorted_vector and move_construct_vector") {
+        const auto sorted = tools::sorted_vector({3, 1, 2}, alloc);
+        REQUIRE(std::vector<int>(sorted.begin(), sorted.end()) == std::vector<int>({1, 2, 3}));
+        REQUIRE(sorted.get_allocator() == alloc);
+
+        const auto vector = tools::move_construct_vector(std::allocator_arg, alloc, std::make_unique<int>(1), std::make_unique<int>(2));
+        REQUIRE(vector.size() == 2);
+        REQUIRE(*vector[1] == 2);
+        REQUIRE(vector.get_allocator() == alloc);
+    }
+
+#ifdef NONAME_HAS_MEMORY_RESOURCE
+    SECTION("Testing std::pmr containers") {
+        tools::pool_resource pool;
+        std::pmr::vector<std::pmr::string> strings(&pool);
+        strings.emplace_back("a string that is too long for the small string optimization");
+        REQUIRE(pool.bytes_allocated() > 0);
+
+        const auto lines = tools::split_string(std::string("x y z"), ' ', std::pmr::polymorphic_allocator<char>(&arena));
+        REQUIRE((std::is_same<decltype(lines), const std::pmr::vector<std::pmr::string>>::value) == true);
+        REQUIRE(lines[2] == "z");
+        REQUIRE(lines[2].get_allocator().resource() == &arena);
+    }
+#endif
+}
@@ -0,0 +1,157 @@
+//	MIT License
+//
+//	Copyright (c) 2020 Fabian Löschner
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files (the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include <noname_tools/parallel_tools.h>
+
+#include "catch2/catch.hpp"
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <numeric>
+
+using namespace noname;
+
+TEST_CASE("Testing thread_pool") {
+    tools::thread_pool pool(3);
+    REQUIRE(pool.concurrency() == 4);
+
+    SECTION("Every index is visited exactly once") {
+        std::vector<int> visits(100, 0);
+        pool.parallel_for(visits.size(), [&](std::size_t i) { visits[i] += 1; });
+
+        REQUIRE(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+    }
+
+    SECTION("Nested calls do not deadlock") {
+        std::atomic<int> count(0);
+        pool.parallel_for(8, [&](std::size_t) {
+            pool.parallel_for(8, [&](std::size_t) { ++count; });
+        });
+
+        REQUIRE(count == 64);
+    }
+
+    SECTION("Exceptions are rethrown in the calling thread") {
+        std::atomic<int> count(0);
+        REQUIRE_THROWS_AS(pool.parallel_for(10, [&](std::size_t i) {
+            ++count;
+            if (i == 5) throw std::runtime_error("error");
+        }), std::runtime_error);
+        REQUIRE(count == 10);
+    }
+
+    SECTION("Pool without workers runs on the calling thread") {
+        tools::thread_pool serial_pool(0);
+        REQUIRE(serial_pool.concurrency() == 1);
+
+        std::vector<std::size_t> order;
+        serial_pool.parallel_for(4, [&](std::size_t i) { order.push_back(i); });
+
+        REQUIRE(order == std::vector<std::size_t>({0, 1, 2, 3}));
+    }
+}
+
+TEST_CASE("Testing parallel_policy") {
+    tools::thread_pool pool(2);
+
+    REQUIRE(&tools::par.executor() == &tools::default_thread_pool());
+    REQUIRE(tools::par.chunk_count() == tools::default_thread_pool().concurrency());
+    REQUIRE(&tools::parallel_policy(&pool).executor() == &pool);
+    REQUIRE(tools::parallel_policy(&pool).chunk_count() == 3);
+    REQUIRE(tools::parallel_policy(&pool, 16).chunk_count() == 16);
+}
+
+TEST_CASE("Testing cancellation and progress reporting") {
+    tools::thread_pool pool(2);
+
+    SECTION("Cancelled policies skip the remaining chunks") {
+        tools::cancellation_token token;
+        const tools::parallel_policy policy(&pool, 0, &token);
+        std::atomic<int> calls(0);
+        REQUIRE_THROWS_AS(policy.parallel_for(1000, [&](std::size_t) {
+            if (++calls == 10) token.cancel();
+        }), tools::operation_cancelled);
+        REQUIRE(calls >= 10);
+        REQUIRE(calls < 1000);
+
+        calls = 0;
+        REQUIRE(token.is_cancelled());
+        REQUIRE_THROWS_AS(policy.parallel_for(100, [&](std::size_t) { calls++; }), tools::operation_cancelled);
+        REQUIRE(calls == 0);
+
+        token.reset();
+        policy.parallel_for(10, [&](std::size_t) { calls++; });
+        REQUIRE(calls == 10);
+    }
+
+    SECTION("Progress is reported after every chunk") {
+        std::vector<std::size_t> reported;
+        std::size_t reported_total = 0;
+        tools::progress_monitor monitor([&](std::size_t completed, std::size_t total) {
+            reported.push_back(completed);
+            reported_total = total;
+        });
+        const tools::parallel_policy policy(&pool, 0, nullptr, &monitor);
+        policy.parallel_for(20, [](std::size_t) {});
+
+        std::vector<std::size_t> expected(20);
+        std::iota(expected.begin(), expected.end(), 1);
+        REQUIRE(reported == expected);
+        REQUIRE(reported_total == 20);
+    }
+}
+
+TEST_CASE("Testing sharded_sink") {
+    tools::thread_pool pool(3);
+
+    SECTION("Shards are merged in shard order") {
+        tools::sharded_sink<int> sink(8);
+        pool.parallel_for(8, [&](std::size_t k) {
+            auto out = sink.shard(k);
+            for (int i = 0; i < 100; ++i) *out++ = static_cast<int>(k) * 100 + i;
+        });
+
+        REQUIRE(sink.size() == 800);
+        std::vector<int> expected(800);
+        for (int i = 0; i < 800; ++i) expected[i] = i;
+        REQUIRE(sink.merge() == expected);
+        REQUIRE(sink.size() == 0);
+    }
+
+    SECTION("Unordered merge and merge into an output iterator") {
+        tools::sharded_sink<int> sink(3);
+        sink.buffer(0) = {1, 2};
+        sink.buffer(1) = {3, 4, 5, 6};
+        sink.buffer(2) = {7};
+
+        auto values = sink.merge_unordered();
+        std::sort(values.begin(), values.end());
+        REQUIRE(values == std::vector<int>({1, 2, 3, 4, 5, 6, 7}));
+
+        sink.buffer(2) = {8, 9};
+        std::vector<int> result;
+        sink.merge(std::back_inserter(result));
+        REQUIRE(result == std::vector<int>({8, 9}));
+    }
+}
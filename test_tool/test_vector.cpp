@@ -28,6 +28,8 @@
 #include <type_traits>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <functional>
 
 using namespace noname;
 
@@ -52,6 +54,12 @@ TEST_CASE("Testing sorted_vector") {
         REQUIRE(sortedVector.at(2) == "ccc");
     }
 
+    SECTION("Call with comparator") {
+        const auto sortedVector = tools::sorted_vector(std::vector<std::string>({"bbb", "aaa", "ccc"}), std::greater<std::string>());
+
+        REQUIRE(sortedVector == std::vector<std::string>({"ccc", "bbb", "aaa"}));
+    }
+
     SECTION("Call with empty r-value vector") {
         const auto sortedVector = tools::sorted_vector<std::string>(std::vector<std::string>());
 
@@ -71,4 +79,20 @@ TEST_CASE("Testing move_construct_vector") {
         REQUIRE((std::is_same<decltype(vector), const std::vector<std::unique_ptr<int>>>::value) == true);
         REQUIRE(vector.size() == 3);
     }
+
+    SECTION("Testing move_construct_small_vector") {
+        const auto vector = tools::move_construct_small_vector(
+                std::make_unique<int>(1),
+                std::make_unique<int>(2)
+        );
+
+        REQUIRE((std::is_same<decltype(vector), const tools::small_vector<std::unique_ptr<int>, 2>>::value) == true);
+        REQUIRE(vector.is_inline());
+        REQUIRE(*vector[0] == 1);
+        REQUIRE(*vector[1] == 2);
+
+        const auto larger = tools::move_construct_small_vector<4>(std::string("a"), std::string("b"), std::string("c"));
+        REQUIRE(larger.capacity() == 4);
+        REQUIRE(larger == tools::small_vector<std::string, 4>({"a", "b", "c"}));
+    }
 }